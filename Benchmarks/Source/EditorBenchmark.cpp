@@ -0,0 +1,165 @@
+/*
+ ==============================================================================
+ ZirkOSC: VST and AU audio plug-in enabling spatial movement of sound sources in a dome of speakers.
+
+ Copyright (C) 2015  GRIS-UdeM
+
+ Developers: Ludovic Laffineur, Vincent Berthiaume
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ==============================================================================
+ */
+
+#include "EditorBenchmark.h"
+#include "../../Source/PluginProcessor.h"
+#include "../../Source/PluginEditor.h"
+
+String EditorBenchmark::runEditorPaint(){
+    const int aSizes[][2] = {{515, 700}, {1030, 1400}};
+    const int iFrames     = 200;
+    
+    ScopedPointer<ZirkOscAudioProcessor> pProcessor(new ZirkOscAudioProcessor());
+    pProcessor->setIsOscActive(false);
+    ScopedPointer<ZirkOscAudioProcessorEditor> pEditor(dynamic_cast<ZirkOscAudioProcessorEditor*>(pProcessor->createEditor()));
+    
+    String sReport;
+    sReport << "size\tus/frame uncached\tus/frame cached\tspeedup\n";
+    
+    for (int iSize = 0; iSize < numElementsInArray(aSizes); ++iSize){
+        const int iWidth = aSizes[iSize][0], iHeight = aSizes[iSize][1];
+        pEditor->setSize(iWidth, iHeight);
+        Image oFrame(Image::ARGB, iWidth, iHeight, true, SoftwareImageType());
+        double aFrameUs[2];
+        
+        for (int iCached = 0; iCached < 2; ++iCached){
+            pEditor->setBackgroundCacheEnabled(iCached == 1);
+            //first frame renders the cached layer, keep it out of the timing
+            {
+                Graphics g(oFrame);
+                pEditor->paint(g);
+            }
+            int64 iStart = Time::getHighResolutionTicks();
+            for (int iFrame = 0; iFrame < iFrames; ++iFrame){
+                Graphics g(oFrame);
+                pEditor->paint(g);
+            }
+            aFrameUs[iCached] = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - iStart) * 1e6 / iFrames;
+        }
+        sReport << iWidth << "x" << iHeight << "\t" << String(aFrameUs[0], 1) << "\t" << String(aFrameUs[1], 1) << "\t"
+                << String(aFrameUs[0] / aFrameUs[1], 2) << "\n";
+    }
+    pEditor = nullptr;
+    return sReport;
+}
+
+String EditorBenchmark::runEditorStages(){
+    const int iFrames = 200;
+    enum Stages {Background, CachedBackground, SpanArcs, SourcePoints, Trail, Whole, NbrStages};
+    const char *aStageNames[NbrStages] = {"paintBackground", "cached background", "paintSpanArc", "paintSourcePoint", "trail", "paint"};
+    
+    ScopedPointer<ZirkOscAudioProcessor> pProcessor(new ZirkOscAudioProcessor());
+    pProcessor->setIsOscActive(false);
+    pProcessor->setNbrSources(ZirkOSC_Max_Sources);
+    juce::Random oRandom(1);
+    for (int iCurSource = 0; iCurSource < ZirkOSC_Max_Sources; ++iCurSource){
+        SoundSource &oSource = pProcessor->getSources()[iCurSource];
+        oSource = SoundSource(oRandom.nextFloat(), oRandom.nextFloat(), iCurSource + 1);
+        oSource.setAzimuthSpan(oRandom.nextFloat());
+        oSource.setElevationSpan(oRandom.nextFloat());
+    }
+    
+    ScopedPointer<ZirkOscAudioProcessorEditor> pEditor(dynamic_cast<ZirkOscAudioProcessorEditor*>(pProcessor->createEditor()));
+    const int iWidth = 515, iHeight = 700;
+    pEditor->setSize(iWidth, iHeight);
+    
+    //a spiral longer than the trail can hold, so the trail is full
+    for (int iPoint = 0; iPoint < 1000; ++iPoint){
+        float fRadius = .2f + .7f * iPoint / 1000;
+        pProcessor->getPositionTrace().push(fRadius * cosf(iPoint * .05f), fRadius * sinf(iPoint * .05f));
+        if (iPoint % 256 == 0){
+            pEditor->m_oPositionTrail.update(pProcessor->getPositionTrace(), Time::getMillisecondCounter());
+        }
+    }
+    pEditor->m_oPositionTrail.update(pProcessor->getPositionTrace(), Time::getMillisecondCounter());
+    
+    Image oFrame(Image::ARGB, iWidth, iHeight, true, SoftwareImageType());
+    int64 aTicks[NbrStages] = {0};
+    for (int iFrame = 0; iFrame < iFrames; ++iFrame){
+        for (int iStage = 0; iStage < NbrStages; ++iStage){
+            Graphics g(oFrame);
+            int64 iStart = Time::getHighResolutionTicks();
+            switch (iStage){
+                case Background:
+                    pEditor->paintBackground(g);
+                    break;
+                case CachedBackground:
+                    pEditor->drawCachedBackground(g);
+                    break;
+                case SpanArcs:
+                    for (int iCurSource = 0; iCurSource < pProcessor->getNbrSources(); ++iCurSource){
+                        pEditor->paintSpanArc(g, iCurSource);
+                    }
+                    break;
+                case SourcePoints:
+                    pEditor->paintSourcePoint(g);
+                    break;
+                case Trail:
+                    pEditor->m_oPositionTrail.paint(g, Point<float>(pEditor->_ZirkOSC_Center_X, pEditor->_ZirkOSC_Center_Y), pEditor->m_iDomeRadius,
+                                                    Colour(0, 102, 255), Time::getMillisecondCounter());
+                    break;
+                case Whole:
+                    pEditor->paint(g);
+                    break;
+            }
+            aTicks[iStage] += Time::getHighResolutionTicks() - iStart;
+        }
+    }
+    pEditor = nullptr;
+    
+    String sReport;
+    sReport << "stage (" << ZirkOSC_Max_Sources << " sources, " << iWidth << "x" << iHeight << ")\tus/frame\n";
+    for (int iStage = 0; iStage < NbrStages; ++iStage){
+        sReport << aStageNames[iStage] << "\t" << String(Time::highResolutionTicksToSeconds(aTicks[iStage]) * 1e6 / iFrames, 1) << "\n";
+    }
+    return sReport;
+}
+
+String EditorBenchmark::runEditorRefresh(){
+    //one minute of refreshes at 20 Hz
+    const int iRefreshes = 20 * 60;
+    
+    ScopedPointer<ZirkOscAudioProcessor> pProcessor(new ZirkOscAudioProcessor());
+    pProcessor->setIsOscActive(false);
+    ScopedPointer<ZirkOscAudioProcessorEditor> pEditor(dynamic_cast<ZirkOscAudioProcessorEditor*>(pProcessor->createEditor()));
+    pEditor->setSize(515, 700);
+    pEditor->refreshGui();
+    
+    double aRefreshUs[2];
+    for (int iCached = 0; iCached < 2; ++iCached){
+        int64 iStart = Time::getHighResolutionTicks();
+        for (int iRefresh = 0; iRefresh < iRefreshes; ++iRefresh){
+            if (iCached == 0){
+                pEditor->invalidateDisplayedValues();
+            }
+            pEditor->refreshGui();
+        }
+        aRefreshUs[iCached] = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - iStart) * 1e6 / iRefreshes;
+    }
+    pEditor = nullptr;
+    
+    String sReport;
+    sReport << "us/refresh uncached\tus/refresh cached\tspeedup\n";
+    sReport << String(aRefreshUs[0], 2) << "\t" << String(aRefreshUs[1], 2) << "\t" << String(aRefreshUs[0] / aRefreshUs[1], 2) << "\n";
+    return sReport;
+}
@@ -0,0 +1,44 @@
+/*
+ ==============================================================================
+ ZirkOSC: VST and AU audio plug-in enabling spatial movement of sound sources in a dome of speakers.
+
+ Copyright (C) 2015  GRIS-UdeM
+
+ Developers: Ludovic Laffineur, Vincent Berthiaume
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ==============================================================================
+ */
+
+#ifndef __ZirkOSCJUCE__EditorBenchmark__
+#define __ZirkOSCJUCE__EditorBenchmark__
+
+#include "../../JuceLibraryCode/JuceHeader.h"
+
+//! Offscreen editor benchmarks. They create a processor and its editor without putting it on the desktop, so they need the
+//! message manager but no window. ZirkOscAudioProcessorEditor makes this class a friend so each paint stage can be timed alone.
+class EditorBenchmark {
+public:
+    //! Paints an offscreen editor into an Image with the software renderer, with and without the cached background layer.
+    //! Returns the cost per frame of both.
+    static String runEditorPaint();
+    //! Paints an offscreen editor with all sources at random positions and spans and a full position trail, one paint
+    //! stage at a time, with the software renderer. Returns the cost per frame of each stage, as a baseline for GUI work.
+    static String runEditorStages();
+    //! Calls refreshGui on an offscreen editor as its 20 Hz refresh would, with nothing changing in the processor, once
+    //! with every widget rewritten and once with the displayed values cached. Returns the cost per refresh of both.
+    static String runEditorRefresh();
+};
+
+#endif /* defined(__ZirkOSCJUCE__EditorBenchmark__) */
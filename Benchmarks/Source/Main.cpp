@@ -0,0 +1,84 @@
+/*
+ ==============================================================================
+ ZirkOSC: VST and AU audio plug-in enabling spatial movement of sound sources in a dome of speakers.
+
+ Copyright (C) 2015  GRIS-UdeM
+
+ Developers: Ludovic Laffineur, Vincent Berthiaume
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ==============================================================================
+ */
+
+#include "../../JuceLibraryCode/JuceHeader.h"
+#include "TrajectoryBenchmark.h"
+#include "EditorBenchmark.h"
+#include <atomic>
+#include <new>
+#include <cstdlib>
+#include <iostream>
+
+//allocation counter. Replacing the global operator new is only done in this executable: inside the plugin it would replace
+//the allocator of the whole host
+static std::atomic<long long> s_iAllocationCount(0);
+
+void* operator new (std::size_t p_iSize){
+    ++s_iAllocationCount;
+    if (void *p = std::malloc(p_iSize ? p_iSize : 1)){
+        return p;
+    }
+    throw std::bad_alloc();
+}
+void operator delete (void *p) noexcept {
+    std::free(p);
+}
+void operator delete (void *p, std::size_t) noexcept {
+    std::free(p);
+}
+
+long long getBenchmarkAllocationCount(){
+    return s_iAllocationCount;
+}
+
+//! Runs the benchmarks named on the command line, all of them if there are none, and prints their reports as tab separated
+//! tables on the standard output. Nothing is shown on screen, so it can run from a terminal or a build server.
+int main (int argc, char* argv[]){
+    const char *aNames[] = {"trajectories", "constraints", "editor"};
+    StringArray oSelected;
+    for (int iArg = 1; iArg < argc; ++iArg){
+        oSelected.add(argv[iArg]);
+    }
+    for (int iSelected = 0; iSelected < oSelected.size(); ++iSelected){
+        if (!StringArray(aNames, numElementsInArray(aNames)).contains(oSelected[iSelected])){
+            std::cerr << "usage: " << argv[0] << " [trajectories] [constraints] [editor]" << std::endl;
+            return 1;
+        }
+    }
+    const bool bAll = oSelected.size() == 0;
+    
+    //the processor and the editor need the message manager, even without a window
+    ScopedJuceInitialiser_GUI oJuceInitialiser;
+    String sReport;
+    if (bAll || oSelected.contains("trajectories")){
+        sReport << TrajectoryBenchmark::run() << "\n";
+    }
+    if (bAll || oSelected.contains("constraints")){
+        sReport << TrajectoryBenchmark::runConstraintSolver() << "\n";
+    }
+    if (bAll || oSelected.contains("editor")){
+        sReport << EditorBenchmark::runEditorPaint() << "\n" << EditorBenchmark::runEditorStages() << "\n" << EditorBenchmark::runEditorRefresh();
+    }
+    std::cout << sReport << std::flush;
+    return 0;
+}
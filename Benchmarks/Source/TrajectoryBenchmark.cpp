@@ -0,0 +1,397 @@
+/*
+ ==============================================================================
+ ZirkOSC: VST and AU audio plug-in enabling spatial movement of sound sources in a dome of speakers.
+
+ Copyright (C) 2015  GRIS-UdeM
+
+ Developers: Ludovic Laffineur, Vincent Berthiaume
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ==============================================================================
+ */
+
+#include "TrajectoryBenchmark.h"
+#include "../../Source/PluginProcessor.h"
+#include "../../Source/SourceGroup.h"
+#include "../../Source/Constraints.h"
+#include <vector>
+#include <limits>
+#include <tuple>
+
+namespace {
+    //! Playhead we drive ourselves, one block at a time
+    class BenchmarkPlayHead : public AudioPlayHead {
+    public:
+        BenchmarkPlayHead(double p_dSampleRate, double p_dBpm)
+        :m_dSampleRate(p_dSampleRate)
+        {
+            zerostruct(m_oInfo);
+            m_oInfo.bpm                 = p_dBpm;
+            m_oInfo.timeSigNumerator    = 4;
+            m_oInfo.timeSigDenominator  = 4;
+            m_oInfo.isPlaying           = true;
+        }
+        bool getCurrentPosition (CurrentPositionInfo &result) override {
+            result = m_oInfo;
+            return true;
+        }
+        void advance(int p_iSamples){
+            m_oInfo.timeInSamples  += p_iSamples;
+            m_oInfo.timeInSeconds   = m_oInfo.timeInSamples / m_dSampleRate;
+            m_oInfo.ppqPosition     = m_oInfo.timeInSeconds * m_oInfo.bpm / 60;
+        }
+        const CurrentPositionInfo& getInfo() const {
+            return m_oInfo;
+        }
+    private:
+        CurrentPositionInfo m_oInfo;
+        double m_dSampleRate;
+    };
+
+    //! reference positions are computed in double with the standard library, so they do not share the plugin's approximations
+    struct DomeVector {
+        double x, y, z;
+    };
+    
+    DomeVector azimElev01ToVector(double p_dAzim01, double p_dElev01){
+        const double dAzim = (p_dAzim01 * 360 - 180) * double_Pi / 180;
+        const double dElev = p_dElev01 * double_Pi / 2;
+        return { -cos(dElev) * sin(dAzim), -cos(dElev) * cos(dAzim), sin(dElev) };
+    }
+    
+    //! xy in [-1,1] is the dome seen from above
+    DomeVector xyToVector(double p_dX, double p_dY){
+        return { p_dX, p_dY, sqrt(jmax(0., 1 - p_dX*p_dX - p_dY*p_dY)) };
+    }
+    
+    //! angle between 2 positions on the dome, in degrees
+    double getDomeAngle(const DomeVector &a, const DomeVector &b){
+        const double dCrossX = a.y*b.z - a.z*b.y, dCrossY = a.z*b.x - a.x*b.z, dCrossZ = a.x*b.y - a.y*b.x;
+        return atan2(sqrt(dCrossX*dCrossX + dCrossY*dCrossY + dCrossZ*dCrossZ), a.x*b.x + a.y*b.y + a.z*b.z) * 180 / double_Pi;
+    }
+    
+    //! where the trajectories written by run() should be after p_dCycle cycles, clockwise, one way, one turn, no deviation or
+    //! dampening. The spiral is pulled towards p_oEnd, the pendulum ends at the center. Returns false for Random, which has no
+    //! closed form. The drawn path is the half circle of radius .5 that run() draws; its reference is the point of that half
+    //! circle closest to p_oActual.
+    bool getExpectedPosition(int p_iType, double p_dCycle, const DomeVector &p_oStart, double p_dStartAzim01, double p_dStartElev01,
+                             const std::pair<float, float> &p_oEnd, const DomeVector &p_oActual, DomeVector &p_oExpected){
+        const double dProgress = p_dCycle - floor(p_dCycle);
+        switch (p_iType){
+            case Circle:
+                p_oExpected = azimElev01ToVector(p_dStartAzim01 - dProgress, p_dStartElev01);
+                return true;
+            case Ellipse:
+                p_oExpected = azimElev01ToVector(p_dStartAzim01 - dProgress, p_dStartElev01 + (1 - p_dStartElev01) / 2 * fabs(sin(dProgress * 2 * double_Pi)));
+                return true;
+            case Spiral: {
+                const DomeVector oSpiral = azimElev01ToVector(p_dStartAzim01 - dProgress, p_dStartElev01 + dProgress * (1 - p_dStartElev01));
+                p_oExpected = xyToVector(oSpiral.x + dProgress * p_oEnd.first, oSpiral.y + dProgress * p_oEnd.second);
+                return true;
+            }
+            case Pendulum: {
+                //swings along the line from the start to the center, easing in and out
+                const double dSwing = (1 - cos(dProgress * double_Pi)) / 2;
+                p_oExpected = xyToVector(p_oStart.x * (1 - dSwing), p_oStart.y * (1 - dSwing));
+                return true;
+            }
+            case Drawn: {
+                const double dAngle = jlimit(0., double_Pi, atan2(p_oActual.y, p_oActual.x));
+                p_oExpected = xyToVector(.5 * cos(dAngle), .5 * sin(dAngle));
+                return true;
+            }
+            default:
+                return false;
+        }
+    }
+}
+
+String TrajectoryBenchmark::run(){
+    const double dSampleRate    = 44100;
+    const float  fDurationBeats = 4;
+    const int    aBufferSizes[] = {16, 64, 256, 1024, 4096};
+    const double aTempos[]      = {60, 120, 180};
+    //away from the center, so the spiral's translation towards its end point is checked too
+    const std::pair<float, float> oSpiralEnd(.3f, -.2f);
+
+    ScopedPointer<ZirkOscAudioProcessor> pProcessor(new ZirkOscAudioProcessor());
+    pProcessor->setIsOscActive(false);
+    pProcessor->setSelectedSource(0);
+
+    //a half circle for the drawn trajectory
+    TrajectorySpline oSpline;
+    for (int i = 0; i <= 50; ++i){
+        oSpline.addPoint(.5f * cosf(i * float_Pi / 50), .5f * sinf(i * float_Pi / 50));
+    }
+    oSpline.build();
+
+    String sReport;
+    sReport << "type\tbuffer\tbpm\tblocks\tns/block\tallocs/block\tmax deviation (deg)\n";
+
+    for (int iType = 1; iType < TotalNumberTrajectories; ++iType){
+        for (int iBuffer = 0; iBuffer < numElementsInArray(aBufferSizes); ++iBuffer){
+            for (int iTempo = 0; iTempo < numElementsInArray(aTempos); ++iTempo){
+                BenchmarkPlayHead oPlayHead(dSampleRate, aTempos[iTempo]);
+                pProcessor->setPlayHead(&oPlayHead);
+                SoundSource &oSource = pProcessor->getSources()[0];
+                const DomeVector oStart  = xyToVector(oSource.getX(), oSource.getY());
+                const double dStartAzim01 = oSource.getAzimuth01();
+                const double dStartElev01 = oSource.getElevation01();
+                const std::pair<float, float> oEnd = iType == Spiral ? oSpiralEnd : std::make_pair(0.f, 0.f);
+
+                Trajectory::Ptr pTrajectory = Trajectory::CreateTrajectory(iType, pProcessor, fDurationBeats, true, CW, false, 1, 0, oEnd,
+                                                                           1, 0, 0, 1, .5, 1, oSpline);
+                int64 iTicks = 0, iBlocks = 0;
+                long long iAllocations = 0;
+                double dMaxError = 0;
+                bool bHasReference = false;
+                bool bDone = false;
+                while (!bDone){
+                    long long iAllocationsBefore = getBenchmarkAllocationCount();
+                    int64 iStart = Time::getHighResolutionTicks();
+                    bDone = pTrajectory->process(oPlayHead.getInfo(), dSampleRate);
+                    iTicks += Time::getHighResolutionTicks() - iStart;
+                    iAllocations += getBenchmarkAllocationCount() - iAllocationsBefore;
+                    ++iBlocks;
+
+                    //check against the closed form of the path; the last block restores the initial locations, so skip it
+                    if (!bDone){
+                        const DomeVector oActual = xyToVector(oSource.getX(), oSource.getY());
+                        DomeVector oExpected;
+                        if (getExpectedPosition(iType, oPlayHead.getInfo().ppqPosition / fDurationBeats, oStart, dStartAzim01, dStartElev01, oEnd, oActual, oExpected)){
+                            dMaxError = jmax(dMaxError, getDomeAngle(oActual, oExpected));
+                            bHasReference = true;
+                        }
+                    }
+                    oPlayHead.advance(aBufferSizes[iBuffer]);
+                }
+                pProcessor->setPlayHead(nullptr);
+
+                double dNsPerBlock = Time::highResolutionTicksToSeconds(iTicks) * 1e9 / iBlocks;
+                sReport << Trajectory::GetTrajectoryName(iType) << "\t" << aBufferSizes[iBuffer] << "\t" << aTempos[iTempo] << "\t"
+                        << iBlocks << "\t" << String(dNsPerBlock, 1) << "\t" << String(static_cast<double>(iAllocations) / iBlocks, 3) << "\t"
+                        << (bHasReference ? String(dMaxError, 4) : String("-")) << "\n";
+            }
+        }
+    }
+    return sReport;
+}
+
+namespace {
+    void initBenchmarkSources(SoundSource *p_pSources, int p_iNbrSources){
+        for (int iCurSource = 0; iCurSource < p_iNbrSources; ++iCurSource){
+            p_pSources[iCurSource] = SoundSource(static_cast<float>(iCurSource) / p_iNbrSources, .3f, iCurSource + 1);
+            p_pSources[iCurSource].setPrevLoc01(p_pSources[iCurSource].getX01(), p_pSources[iCurSource].getY01(),
+                                                p_pSources[iCurSource].getAzimuth01(), p_pSources[iCurSource].getElevation01());
+        }
+    }
+    //! what the gui and osc do after a move
+    float readBackSources(SoundSource *p_pSources, int p_iNbrSources){
+        float fSum = 0;
+        for (int iCurSource = 0; iCurSource < p_iNbrSources; ++iCurSource){
+            fSum += p_pSources[iCurSource].getX01() + p_pSources[iCurSource].getY01() + p_pSources[iCurSource].getAzimuth01() + p_pSources[iCurSource].getElevation01();
+        }
+        return fSum;
+    }
+    //! the leader drifts in azimuth and goes up and down, so the other sources keep crossing the zenith and the horizon
+    void moveBenchmarkLeader(SoundSource &p_oLeader, int p_iMove){
+        p_oLeader.setAzimuth01(p_iMove * .0016f - floorf(p_iMove * .0016f));
+        p_oLeader.setElevation01(.5f + .45f * sinf(p_iMove * .01f));
+        p_oLeader.synchronize();
+    }
+    
+    //! The circular move as the processor did it before the batched solver (moveCircular): every other source is read back
+    //! through getParameter, rebuilt in editor pixels, converted to azimuth and elevation, moved by the leader's delta and
+    //! written back, one source at a time and through pairs and tuples. The conversions are SoundSource's current ones, so
+    //! only the structure of the two solvers is compared. The parameter ids of sources past the 8th are made up the same way.
+    class BaselineCircularSolver {
+    public:
+        BaselineCircularSolver(SoundSource *p_pSources, int p_iNbrSources)
+        :m_pSources(p_pSources)
+        ,m_iNbrSources(p_iNbrSources)
+        {
+            for (int iCurSource = 0; iCurSource < SourceGroup::s_kiMaxSources; ++iCurSource){
+                m_iElevationStatus[iCurSource]  = normalRange;
+                m_fElevOverflow[iCurSource]     = s_kfDomeRadius;
+            }
+            zerostruct(m_fOtherParameters);
+        }
+        void move(int p_iSelSource){
+            //calculate delta azim+elev for selected source
+            SoundSource &oLeader = m_pSources[p_iSelSource];
+            float fSelectedDeltaAzim01, fSelectedDeltaElev01;
+            std::tie(fSelectedDeltaAzim01, fSelectedDeltaElev01) = std::make_pair(oLeader.getAzimuth01() - oLeader.getPrevAzim01(),
+                                                                                  oLeader.getElevation01() - oLeader.getPrevElev01());
+            if (fabsf(fSelectedDeltaAzim01) < .000001 && fabsf(fSelectedDeltaElev01) < .000001){
+                return;
+            }
+            for (int iCurSource = 0; iCurSource < m_iNbrSources; ++iCurSource) {
+                if (iCurSource == p_iSelSource){
+                    oLeader.setPrevLoc01(oLeader.getX01(), oLeader.getY01(), oLeader.getAzimuth01(), oLeader.getElevation01());
+                    continue;
+                }
+                float fCurAzim01, fCurElev01;
+                std::tie(fCurAzim01, fCurElev01) = getCurrentSourcePosition(iCurSource);
+                float fNewX01, fNewY01, fNewAzim01, fNewElev01;
+                std::tie(fNewX01, fNewY01, fNewAzim01, fNewElev01) = getNewSourcePosition(fSelectedDeltaAzim01, fSelectedDeltaElev01, iCurSource, fCurAzim01, fCurElev01);
+                m_pSources[iCurSource].setXYAzimElev01(fNewX01, fNewY01, fNewAzim01, fNewElev01);
+            }
+        }
+    private:
+        enum ElevationStatus {normalRange, over1, under0};
+        static constexpr float s_kfDomeRadius = 172;
+        
+        float getParameter(int index){
+            const int iFirstOther = m_iNbrSources * 5;
+            switch (index - iFirstOther){
+                case 0: return m_fOtherParameters[0];
+                case 1: return m_fOtherParameters[1];
+                case 2: return m_fOtherParameters[2];
+                case 3: return m_fOtherParameters[3];
+                case 4: return m_fOtherParameters[4];
+                case 5: return m_fOtherParameters[5];
+                case 6: return m_fOtherParameters[6];
+                case 7: return m_fOtherParameters[7];
+                case 8: return m_fOtherParameters[8];
+                case 9: return m_fOtherParameters[9];
+            }
+            for (int iCurSrc = 0; iCurSrc < m_iNbrSources; ++iCurSrc){
+                if (ZirkOscAudioProcessor::ZirkOSC_X_ParamId + (iCurSrc*5) == index) {
+                    return m_pSources[iCurSrc].getX01();
+                } else if (ZirkOscAudioProcessor::ZirkOSC_Y_ParamId + (iCurSrc*5) == index){
+                    return m_pSources[iCurSrc].getY01();
+                } else if (ZirkOscAudioProcessor::ZirkOSC_AzimSpan_ParamId + (iCurSrc*5) == index){
+                    return m_pSources[iCurSrc].getAzimuthSpan();
+                } else if (ZirkOscAudioProcessor::ZirkOSC_ElevSpan_ParamId + (iCurSrc*5) == index){
+                    return m_pSources[iCurSrc].getElevationSpan();
+                } else if (ZirkOscAudioProcessor::ZirkOSC_Gain_ParamId + (iCurSrc*5) == index){
+                    return m_pSources[iCurSrc].getGain01();
+                }
+            }
+            return -1.f;
+        }
+        std::pair<float, float> getCurrentSourcePosition(int iCurSource){
+            float fCurAzim01, fCurElev01;
+            float fCurX = getParameter(ZirkOscAudioProcessor::ZirkOSC_X_ParamId + (iCurSource*5)) * 2 * s_kfDomeRadius - s_kfDomeRadius;
+            float fCurY = getParameter(ZirkOscAudioProcessor::ZirkOSC_Y_ParamId + (iCurSource*5)) * 2 * s_kfDomeRadius - s_kfDomeRadius;
+            ElevationStatus elevationStatus = m_iElevationStatus[iCurSource];
+            if (elevationStatus == normalRange){
+                fCurElev01 = SoundSource::XYtoElev01(fCurX / s_kfDomeRadius, fCurY / s_kfDomeRadius);
+                fCurAzim01 = SoundSource::XYtoAzim01(fCurX / s_kfDomeRadius, fCurY / s_kfDomeRadius);
+            } else {
+                float fCurElevOverflow = (m_fElevOverflow[iCurSource] - s_kfDomeRadius) / s_kfDomeRadius;
+                if (elevationStatus == over1){
+                    fCurAzim01 = m_pSources[iCurSource].getPrevAzim01();
+                    fCurElev01 = radianToDegree(acos(fCurElevOverflow));
+                } else {
+                    fCurAzim01 = SoundSource::XYtoAzim01(fCurX / s_kfDomeRadius, fCurY / s_kfDomeRadius);
+                    fCurElev01 = radianToDegree(-asin(fCurElevOverflow));
+                }
+                fCurElev01 = HRToPercent(fCurElev01, ZirkOSC_Elev_Min, ZirkOSC_Elev_Max);
+            }
+            return std::make_pair(fCurAzim01, fCurElev01);
+        }
+        std::tuple<float, float, float, float> getNewSourcePosition(const float &fSelectedDeltaAzim01, const float &fSelectedDeltaElev01, const int &iCurSource,
+                                                                    const float &fCurAzim01, const float &fCurElev01){
+            float fNewX01, fNewY01, fCurElevOverflow;
+            float fNewAzim01 = checkAndFixAzim01Bounds(fCurAzim01 + fSelectedDeltaAzim01);
+            float fNewElev01 = fCurElev01 + fSelectedDeltaElev01;
+            if (fNewElev01 >= 1 - std::numeric_limits<float>::epsilon()){
+                m_iElevationStatus[iCurSource] = over1;
+                fCurElevOverflow = s_kfDomeRadius + s_kfDomeRadius * cos(degreeToRadian(PercentToHR(fNewElev01, ZirkOSC_Elev_Min, ZirkOSC_Elev_Max)));
+                fNewElev01 = 1;
+                SoundSource::azimElev01toXY01(fNewAzim01, fNewElev01, fNewX01, fNewY01, fCurElevOverflow / s_kfDomeRadius);
+            } else if (fNewElev01 < 0){
+                m_iElevationStatus[iCurSource] = under0;
+                fCurElevOverflow = s_kfDomeRadius - s_kfDomeRadius * sin(degreeToRadian(PercentToHR(fNewElev01, ZirkOSC_Elev_Min, ZirkOSC_Elev_Max)));
+                fNewElev01 = 0;
+                SoundSource::azimElev01toXY01(fNewAzim01, fNewElev01, fNewX01, fNewY01, fCurElevOverflow / s_kfDomeRadius);
+            } else {
+                m_iElevationStatus[iCurSource] = normalRange;
+                SoundSource::azimElev01toXY01(fNewAzim01, fNewElev01, fNewX01, fNewY01);
+                fCurElevOverflow = s_kfDomeRadius;
+            }
+            m_fElevOverflow[iCurSource] = fCurElevOverflow;
+            m_pSources[iCurSource].setPrevLoc01(fNewX01, fNewY01, fNewAzim01, fNewElev01);
+            return std::make_tuple(fNewX01, fNewY01, fNewAzim01, fNewElev01);
+        }
+        
+        SoundSource    *m_pSources;
+        int             m_iNbrSources;
+        ElevationStatus m_iElevationStatus[SourceGroup::s_kiMaxSources];
+        float           m_fElevOverflow[SourceGroup::s_kiMaxSources];
+        float           m_fOtherParameters[10];
+    };
+}
+
+String TrajectoryBenchmark::runConstraintSolver(){
+    const int aNbrSources[] = {8, 64};
+    const int iMoves        = 20000;
+    
+    String sReport;
+    sReport << "sources\tns/move per source\tns/move batched\tspeedup\n";
+    
+    for (int iRun = 0; iRun < numElementsInArray(aNbrSources); ++iRun){
+        const int iNbrSources = aNbrSources[iRun];
+        std::vector<SoundSource> oSources(iNbrSources);
+        SoundSource *pSources = oSources.data();
+        float fChecksum = 0;
+        
+        //per source, as moveCircular did
+        initBenchmarkSources(pSources, iNbrSources);
+        BaselineCircularSolver oBaseline(pSources, iNbrSources);
+        int64 iStart = Time::getHighResolutionTicks();
+        for (int iMove = 0; iMove < iMoves; ++iMove){
+            moveBenchmarkLeader(pSources[0], iMove);
+            oBaseline.move(0);
+            fChecksum += readBackSources(pSources, iNbrSources);
+        }
+        double dPerSourceNs = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - iStart) * 1e9 / iMoves;
+        
+        //batched, as solveMovementConstraint does
+        initBenchmarkSources(pSources, iNbrSources);
+        SourceGroup oGroup;
+        AzimuthOrder oAzimuthOrder;
+        iStart = Time::getHighResolutionTicks();
+        for (int iMove = 0; iMove < iMoves; ++iMove){
+            SoundSource &oLeader = pSources[0];
+            moveBenchmarkLeader(oLeader, iMove);
+            ConstraintContext oContext;
+            oContext.m_pSources         = pSources;
+            oContext.m_iNbrSources      = iNbrSources;
+            oContext.m_iLeader          = 0;
+            oContext.m_fLeaderX01       = oLeader.getX01();
+            oContext.m_fLeaderY01       = oLeader.getY01();
+            oContext.m_fLeaderAzim01    = oLeader.getAzimuth01();
+            oContext.m_fLeaderElev01    = oLeader.getElevation01();
+            oContext.m_bEnforce         = false;
+            oContext.m_pAzimuthOrder    = &oAzimuthOrder;
+            float fPrevX01, fPrevY01;
+            oLeader.getPrevXY01(fPrevX01, fPrevY01);
+            oContext.m_fDeltaX01        = oContext.m_fLeaderX01 - fPrevX01;
+            oContext.m_fDeltaY01        = oContext.m_fLeaderY01 - fPrevY01;
+            oContext.m_fDeltaAzim01     = oContext.m_fLeaderAzim01 - oLeader.getPrevAzim01();
+            oContext.m_fDeltaElev01     = oContext.m_fLeaderElev01 - oLeader.getPrevElev01();
+            oLeader.setPrevLoc01(oContext.m_fLeaderX01, oContext.m_fLeaderY01, oContext.m_fLeaderAzim01, oContext.m_fLeaderElev01);
+            solveConstraint(Circular, oContext, oGroup);
+            fChecksum += readBackSources(pSources, iNbrSources);
+        }
+        double dBatchedNs = Time::highResolutionTicksToSeconds(Time::getHighResolutionTicks() - iStart) * 1e9 / iMoves;
+        
+        //the checksum keeps the optimizer from dropping the reads
+        sReport << iNbrSources << "\t" << String(dPerSourceNs, 1) << "\t" << String(dBatchedNs, 1) << "\t"
+                << String(dPerSourceNs / dBatchedNs, 2) << (fChecksum == 0 ? " " : "") << "\n";
+    }
+    return sReport;
+}
@@ -0,0 +1,45 @@
+/*
+ ==============================================================================
+ ZirkOSC: VST and AU audio plug-in enabling spatial movement of sound sources in a dome of speakers.
+
+ Copyright (C) 2015  GRIS-UdeM
+
+ Developers: Ludovic Laffineur, Vincent Berthiaume
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ==============================================================================
+ */
+
+#ifndef __ZirkOSCJUCE__TrajectoryBenchmark__
+#define __ZirkOSCJUCE__TrajectoryBenchmark__
+
+#include "../../JuceLibraryCode/JuceHeader.h"
+
+//! number of calls to the global operator new so far. The benchmark executable replaces operator new to count them, the
+//! plugin never does
+long long getBenchmarkAllocationCount();
+
+class TrajectoryBenchmark {
+public:
+    //! Writes every trajectory type through Trajectory::CreateTrajectory against a simulated playhead, for buffer sizes
+    //! from 16 to 4096 samples and several tempos, on a private processor instance. Returns one line per run with the
+    //! cost per block, the allocations per block and, where the path is known analytically, the largest deviation from it.
+    static String run();
+    //! Moves groups of 8 and 64 sources after the same leader under the circular constraint, once source by source through
+    //! getParameter as moveCircular did, and once through the batched solver, then reads every position back. Returns the
+    //! cost per move of both paths.
+    static String runConstraintSolver();
+};
+
+#endif /* defined(__ZirkOSCJUCE__TrajectoryBenchmark__) */
@@ -0,0 +1,177 @@
+/*
+ ==============================================================================
+ ZirkOSC: VST and AU audio plug-in enabling spatial movement of sound sources in a dome of speakers.
+
+ Copyright (C) 2015  GRIS-UdeM
+
+ Developers: Ludovic Laffineur, Vincent Berthiaume
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ==============================================================================
+ */
+
+
+#include "Constraints.h"
+
+void AzimuthOrder::update(SoundSource *p_pSources, int p_iNbrSources, int p_iLeader, float p_fLeaderAzim01){
+    jassert(p_iNbrSources <= SourceGroup::s_kiMaxSources);
+    float fAzims[SourceGroup::s_kiMaxSources];
+    for (int iCurSrc = 0; iCurSrc < p_iNbrSources; ++iCurSrc){
+        fAzims[iCurSrc] = (iCurSrc == p_iLeader) ? p_fLeaderAzim01 : p_pSources[iCurSrc].getAzimuth01();
+    }
+    //start over when the number of sources changes
+    if (m_iSize != p_iNbrSources){
+        for (int iCurPos = 0; iCurPos < p_iNbrSources; ++iCurPos){
+            m_iOrder[iCurPos] = iCurPos;
+        }
+        m_iSize = p_iNbrSources;
+    }
+    //insertion pass over the previous order: sorted entries cost one comparison, a moved source is shifted to its new place
+    for (int iCurPos = 1; iCurPos < p_iNbrSources; ++iCurPos){
+        int   iSrc  = m_iOrder[iCurPos];
+        float fAzim = fAzims[iSrc];
+        int   iPos  = iCurPos;
+        for (; iPos > 0 && fAzims[m_iOrder[iPos-1]] > fAzim; --iPos){
+            m_iOrder[iPos] = m_iOrder[iPos-1];
+        }
+        m_iOrder[iPos] = iSrc;
+    }
+    for (int iCurPos = 0; iCurPos < p_iNbrSources; ++iCurPos){
+        m_iRank[m_iOrder[iCurPos]] = iCurPos;
+    }
+}
+
+namespace {
+    float wrap01(float p_fValue){
+        return p_fValue - floorf(p_fValue);
+    }
+    
+    //! sources move on their own
+    struct IndependentConstraint : public Constraint<IndependentConstraint> {
+        static const SourceGroup::Space s_kSpace = SourceGroup::XY01;
+        static const bool s_kbMovesOthers = false;
+        void solveSource(const ConstraintContext &, int, float &, float &, float &) {}
+    };
+    
+    //! the group turns with the leader as one rigid body, so it keeps its shape
+    struct CircularConstraint : public Constraint<CircularConstraint> {
+        static const SourceGroup::Space s_kSpace = SourceGroup::DomeVectors;
+        void prepare(ConstraintContext &p_oContext){
+            //tilt along the meridian the leader was on, about the horizontal axis perpendicular to it...
+            float fPrevAzim01 = p_oContext.m_fLeaderAzim01 - p_oContext.m_fDeltaAzim01;
+            float fAzimuth = PercentToHR(fPrevAzim01, ZirkOSC_Azim_Min, ZirkOSC_Azim_Max) * ZirkMath::kDegreeToRadian;
+            ZirkVector3 oTiltAxis = { -ZirkMath::cos(fAzimuth), ZirkMath::sin(fAzimuth), 0 };
+            ZirkRotation oTilt = ZirkRotation::aboutAxis(oTiltAxis, p_oContext.m_fDeltaElev01 * (ZirkOSC_Elev_Max - ZirkOSC_Elev_Min) * ZirkMath::kDegreeToRadian);
+            //...then turn around the zenith. Azimuths go clockwise when seen from above
+            ZirkRotation oTurn = ZirkRotation::aboutAxis({0, 0, 1}, -p_oContext.m_fDeltaAzim01 * (ZirkOSC_Azim_Max - ZirkOSC_Azim_Min) * ZirkMath::kDegreeToRadian);
+            m_oRotation = oTurn * oTilt;
+        }
+        void solveSource(const ConstraintContext &, int, float &x, float &y, float &z){
+            ZirkVector3 oVector = m_oRotation.apply({x, y, z});
+            x = oVector.x;
+            y = oVector.y;
+            z = oVector.z;
+        }
+        ZirkRotation m_oRotation;
+    };
+    
+    //! all sources are at the leader's elevation and turn with it
+    struct EqualElevConstraint : public Constraint<EqualElevConstraint> {
+        static const SourceGroup::Space s_kSpace = SourceGroup::AzimElev01;
+        static const bool s_kbHasFormation = true;
+        void solveSource(const ConstraintContext &p_oContext, int, float &p_fAzim01, float &p_fElev01, float &){
+            p_fAzim01 = wrap01(p_fAzim01 + p_oContext.m_fDeltaAzim01);
+            p_fElev01 = p_oContext.m_fLeaderElev01;
+        }
+    };
+    
+    //! sources are spread evenly in azimuth starting from the leader, each keeping its neighbours. With kbEqualElev,
+    //! they are also at the leader's elevation, otherwise they follow its elevation changes
+    template <bool kbEqualElev>
+    struct EqualAzimConstraint : public Constraint<EqualAzimConstraint<kbEqualElev>> {
+        static const SourceGroup::Space s_kSpace = SourceGroup::AzimElev01;
+        static const bool s_kbHasFormation = true;
+        void prepare(ConstraintContext &p_oContext){
+            //sort with the leader where it was, so a jump does not reorder the formation
+            p_oContext.m_pAzimuthOrder->update(p_oContext.m_pSources, p_oContext.m_iNbrSources, p_oContext.m_iLeader,
+                                               wrap01(p_oContext.m_fLeaderAzim01 - p_oContext.m_fDeltaAzim01));
+            m_iLeaderRank   = p_oContext.m_pAzimuthOrder->getRank(p_oContext.m_iLeader);
+            m_fEqualDelta   = 1.f / p_oContext.m_iNbrSources;
+        }
+        void solveSource(const ConstraintContext &p_oContext, int p_iSource, float &p_fAzim01, float &p_fElev01, float &){
+            int iDistance = p_oContext.m_pAzimuthOrder->getRank(p_iSource) - m_iLeaderRank;
+            if (iDistance < 0){
+                iDistance += p_oContext.m_iNbrSources;
+            }
+            p_fAzim01 = wrap01(p_oContext.m_fLeaderAzim01 + iDistance * m_fEqualDelta);
+            p_fElev01 = kbEqualElev ? p_oContext.m_fLeaderElev01 : jlimit(0.f, 1.f, p_fElev01 + p_oContext.m_fDeltaElev01);
+        }
+        int   m_iLeaderRank;
+        float m_fEqualDelta;
+    };
+    
+    //! sources keep their offset to the leader in xy
+    struct DeltaLockConstraint : public Constraint<DeltaLockConstraint> {
+        static const SourceGroup::Space s_kSpace = SourceGroup::XY01;
+        void solveSource(const ConstraintContext &p_oContext, int, float &p_fX01, float &p_fY01, float &){
+            p_fX01 += p_oContext.m_fDeltaX01;
+            p_fY01 += p_oContext.m_fDeltaY01;
+        }
+    };
+    
+    //! sources are the leader's mirror image about an axis through the dome center, kiAxisDegrees counter-clockwise from x
+    template <int kiAxisDegrees>
+    struct MirrorConstraint : public Constraint<MirrorConstraint<kiAxisDegrees>> {
+        static const SourceGroup::Space s_kSpace = SourceGroup::XY01;
+        static const bool s_kbHasFormation = true;
+        void prepare(ConstraintContext &p_oContext){
+            float fAxis = kiAxisDegrees * ZirkMath::kDegreeToRadian;
+            float fAxisX = ZirkMath::cos(fAxis), fAxisY = ZirkMath::sin(fAxis);
+            float fX = p_oContext.m_fLeaderX01 - .5f, fY = p_oContext.m_fLeaderY01 - .5f;
+            float fProjection = fX * fAxisX + fY * fAxisY;
+            m_fMirrorX01 = 2 * fProjection * fAxisX - fX + .5f;
+            m_fMirrorY01 = 2 * fProjection * fAxisY - fY + .5f;
+        }
+        void solveSource(const ConstraintContext &, int, float &p_fX01, float &p_fY01, float &){
+            p_fX01 = m_fMirrorX01;
+            p_fY01 = m_fMirrorY01;
+        }
+        float m_fMirrorX01;
+        float m_fMirrorY01;
+    };
+    
+    typedef bool (*ConstraintSolver)(ConstraintContext &, SourceGroup &);
+    
+    //! indexed by AllConstraints
+    const ConstraintSolver s_pConstraintSolvers[] = {
+        nullptr,
+        &IndependentConstraint::solve,      //Independent
+        &CircularConstraint::solve,         //Circular
+        &EqualElevConstraint::solve,        //EqualElev
+        &EqualAzimConstraint<false>::solve, //EqualAzim
+        &EqualAzimConstraint<true>::solve,  //EqualAzimElev
+        &DeltaLockConstraint::solve,        //DeltaLocked
+        &MirrorConstraint<0>::solve,        //SymmetricX
+        &MirrorConstraint<90>::solve        //SymmetricY
+    };
+    static_assert(sizeof(s_pConstraintSolvers) / sizeof(s_pConstraintSolvers[0]) == TotalNumberConstraints, "one solver per constraint");
+}
+
+bool solveConstraint(int p_iConstraint, ConstraintContext &p_oContext, SourceGroup &p_oGroup){
+    if (p_iConstraint < Independent || p_iConstraint >= TotalNumberConstraints){
+        jassertfalse;
+        return false;
+    }
+    return s_pConstraintSolvers[p_iConstraint](p_oContext, p_oGroup);
+}
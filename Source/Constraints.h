@@ -0,0 +1,105 @@
+/*
+ ==============================================================================
+ ZirkOSC: VST and AU audio plug-in enabling spatial movement of sound sources in a dome of speakers.
+
+ Copyright (C) 2015  GRIS-UdeM
+
+ Developers: Ludovic Laffineur, Vincent Berthiaume
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ==============================================================================
+ */
+
+
+#ifndef __ZirkOSCJUCE__Constraints__
+#define __ZirkOSCJUCE__Constraints__
+
+#include "SoundSource.h"
+#include "SourceGroup.h"
+
+//! Source ids sorted by azimuth, kept from one update to the next. Sources move one at a time, so an insertion pass over
+//! the previous order only has a few entries to shift, and nothing is allocated.
+class AzimuthOrder {
+public:
+    //! sort the first p_iNbrSources sources, using p_fLeaderAzim01 as the azimuth of p_iLeader
+    void update(SoundSource *p_pSources, int p_iNbrSources, int p_iLeader, float p_fLeaderAzim01);
+    //! position of p_iSource in the order
+    int getRank(int p_iSource) const {
+        return m_iRank[p_iSource];
+    }
+    int getSource(int p_iRank) const {
+        return m_iOrder[p_iRank];
+    }
+    
+private:
+    int m_iOrder[SourceGroup::s_kiMaxSources];
+    int m_iRank[SourceGroup::s_kiMaxSources];
+    //! number of sources in m_iOrder, 0 until the first update
+    int m_iSize = 0;
+};
+
+//! The move a constraint has to follow: where the leader, ie the source that was moved, is now and by how much it moved.
+//! When the constraint is only enforced, eg because it was just selected, all deltas are 0.
+struct ConstraintContext {
+    SoundSource    *m_pSources;
+    int             m_iNbrSources;
+    int             m_iLeader;
+    float           m_fLeaderX01;
+    float           m_fLeaderY01;
+    float           m_fLeaderAzim01;
+    float           m_fLeaderElev01;
+    float           m_fDeltaX01;
+    float           m_fDeltaY01;
+    float           m_fDeltaAzim01;
+    float           m_fDeltaElev01;
+    bool            m_bEnforce;
+    AzimuthOrder   *m_pAzimuthOrder;
+};
+
+//! Base of all movement constraints, dispatched at compile time. A constraint declares the SourceGroup::Space it works in
+//! and implements solveSource(), which gets the coordinates of one non-leader source and moves them. Constraint::solve()
+//! runs it over all of them in a single loop between SourceGroup::gather() and scatter(). Derived classes can also hide:
+//!     prepare(context)        called once before the loop, to compute what all sources share
+//!     s_kbMovesOthers         false if the other sources never move
+//!     s_kbHasFormation        true if the constraint places the other sources relative to the leader (equal spacing,
+//!                             mirror...), so they are moved as soon as it is enforced, not only when the leader moves
+template <class Derived>
+class Constraint {
+public:
+    static const bool s_kbMovesOthers  = true;
+    static const bool s_kbHasFormation = false;
+    
+    //! returns true if p_oGroup was gathered and moved
+    static bool solve(ConstraintContext &p_oContext, SourceGroup &p_oGroup){
+        if (!Derived::s_kbMovesOthers || (p_oContext.m_bEnforce && !Derived::s_kbHasFormation)){
+            return false;
+        }
+        Derived oConstraint;
+        oConstraint.prepare(p_oContext);
+        p_oGroup.gather(p_oContext.m_pSources, p_oContext.m_iNbrSources, p_oContext.m_iLeader, Derived::s_kSpace);
+        float *pA = p_oGroup.getCoordinates(0), *pB = p_oGroup.getCoordinates(1), *pC = p_oGroup.getCoordinates(2);
+        for (int i = 0; i < p_oGroup.size(); ++i){
+            oConstraint.solveSource(p_oContext, p_oGroup.getSource(i), pA[i], pB[i], pC[i]);
+        }
+        p_oGroup.scatter(p_oContext.m_pSources);
+        return true;
+    }
+    void prepare(ConstraintContext &) {}
+};
+
+//! Move the non-leader sources with the constraint p_iConstraint, one of AllConstraints. Returns true if they were moved.
+//! To add a constraint, derive it from Constraint and add it to the table in Constraints.cpp, in AllConstraints order.
+bool solveConstraint(int p_iConstraint, ConstraintContext &p_oContext, SourceGroup &p_oGroup);
+
+#endif /* defined(__ZirkOSCJUCE__Constraints__) */
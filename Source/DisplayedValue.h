@@ -0,0 +1,56 @@
+/*
+ ==============================================================================
+ ZirkOSC: VST and AU audio plug-in enabling spatial movement of sound sources in a dome of speakers.
+
+ Copyright (C) 2015  GRIS-UdeM
+
+ Developers: Ludovic Laffineur, Vincent Berthiaume
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ==============================================================================
+ */
+
+
+#ifndef __ZirkOSCJUCE__DisplayedValue__
+#define __ZirkOSCJUCE__DisplayedValue__
+
+//! The last value shown by a widget. refreshGui only touches a widget when update() says its value changed, so
+//! a refresh where nothing changed does no text formatting, layout or repaint at all.
+template <typename ValueType>
+class DisplayedValue {
+public:
+    DisplayedValue()
+    :m_bValid(false)
+    {}
+    
+    //! remember p_value and return true if the widget has to show it
+    bool update(const ValueType &p_value){
+        if (m_bValid && m_value == p_value){
+            return false;
+        }
+        m_value  = p_value;
+        m_bValid = true;
+        return true;
+    }
+    //! the widget may show something else now (eg, the user typed in it), so the next update() goes through
+    void invalidate(){
+        m_bValid = false;
+    }
+    
+private:
+    ValueType m_value;
+    bool m_bValid;
+};
+
+#endif /* defined(__ZirkOSCJUCE__DisplayedValue__) */
@@ -0,0 +1,51 @@
+/*
+ ==============================================================================
+ ZirkOSC: VST and AU audio plug-in enabling spatial movement of sound sources in a dome of speakers.
+
+ Copyright (C) 2015  GRIS-UdeM
+
+ Developers: Ludovic Laffineur, Vincent Berthiaume
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ==============================================================================
+ */
+
+
+#include "FrameTicker.h"
+#include "ZirkConstants.h"
+
+void FrameTicker::requestFrame(Client *p_pClient){
+    m_aPending.addIfNotAlreadyThere(p_pClient);
+    if (!isTimerRunning()){
+        startTimer(ZirkOSC_frame_timerDelay);
+    }
+}
+
+void FrameTicker::cancelFrame(Client *p_pClient){
+    m_aPending.removeAllInstancesOf(p_pClient);
+    m_aTicking.removeAllInstancesOf(p_pClient);
+}
+
+void FrameTicker::timerCallback(){
+    //clients may ask for another frame, or be deleted, while we tick them
+    m_aTicking.swapWith(m_aPending);
+    while (m_aTicking.size() > 0){
+        Client *pClient = m_aTicking.getUnchecked(0);
+        m_aTicking.remove(0);
+        pClient->frameTick();
+    }
+    if (m_aPending.size() == 0){
+        stopTimer();
+    }
+}
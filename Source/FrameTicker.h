@@ -0,0 +1,53 @@
+/*
+ ==============================================================================
+ ZirkOSC: VST and AU audio plug-in enabling spatial movement of sound sources in a dome of speakers.
+
+ Copyright (C) 2015  GRIS-UdeM
+
+ Developers: Ludovic Laffineur, Vincent Berthiaume
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ==============================================================================
+ */
+
+
+#ifndef __ZirkOSCJUCE__FrameTicker__
+#define __ZirkOSCJUCE__FrameTicker__
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//! One timer shared by all open editors, through a SharedResourcePointer. Clients ask for a frame when something they show
+//! has changed; all requests made before the next tick are served by a single frameTick() call per client. The timer only
+//! runs while frames are pending, so idle editors cost no wakeups at all.
+class FrameTicker : private Timer {
+public:
+    class Client {
+    public:
+        virtual ~Client() {}
+        virtual void frameTick() = 0;
+    };
+    
+    //! must be called on the message thread
+    void requestFrame(Client *p_pClient);
+    //! forget pending requests from p_pClient, call this before it is deleted
+    void cancelFrame(Client *p_pClient);
+    
+private:
+    void timerCallback() override;
+    
+    Array<Client*> m_aPending;
+    Array<Client*> m_aTicking;
+};
+
+#endif /* defined(__ZirkOSCJUCE__FrameTicker__) */
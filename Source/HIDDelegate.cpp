@@ -251,12 +251,12 @@ void HIDDelegate::JoystickUsed(uint32_t usage, float scaledValue, double minValu
             //Switch to detect what part of the device is being used
             switch (usage) {
                 case 48:{
-                    vx = 2*ZirkOscAudioProcessor::s_iDomeRadius * ((scaledValue-minValue)/(maxValue-minValue)) - ZirkOscAudioProcessor::s_iDomeRadius;
+                    vx = 2 * ((scaledValue-minValue)/(maxValue-minValue)) - 1;
 //                    //clamp coordinates to circle
 //                    float fCurR = hypotf(vx, vy);
-//                    if ( fCurR > ZirkOscAudioProcessor::s_iDomeRadius){
+//                    if ( fCurR > 1){
 //                        break;
-//                        float fExtraRatio = ZirkOscAudioProcessor::s_iDomeRadius / fCurR;
+//                        float fExtraRatio = 1 / fCurR;
 //                        vx *= fExtraRatio;
 //                    }
 
@@ -264,12 +264,12 @@ void HIDDelegate::JoystickUsed(uint32_t usage, float scaledValue, double minValu
                     break;
                 }
                 case 49:{
-                    vy = 2*ZirkOscAudioProcessor::s_iDomeRadius * ((scaledValue-minValue)/(maxValue-minValue)) - ZirkOscAudioProcessor::s_iDomeRadius;
+                    vy = 2 * ((scaledValue-minValue)/(maxValue-minValue)) - 1;
 //                    //clamp coordinates to circle
 //                    float fCurR = hypotf(vx, vy);
-//                    if ( fCurR > ZirkOscAudioProcessor::s_iDomeRadius){
+//                    if ( fCurR > 1){
 //                        break;
-//                        float fExtraRatio = ZirkOscAudioProcessor::s_iDomeRadius / fCurR;
+//                        float fExtraRatio = 1 / fCurR;
 //                        vy *= fExtraRatio;
 //                    }
                     mEditor->move(iCurButton, vx, vy);
@@ -0,0 +1,133 @@
+/*
+ ==============================================================================
+ ZirkOSC: VST and AU audio plug-in enabling spatial movement of sound sources in a dome of speakers.
+
+ Copyright (C) 2015  GRIS-UdeM
+
+ Developers: Ludovic Laffineur, Vincent Berthiaume
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ==============================================================================
+ */
+
+
+#include "PerformanceStats.h"
+
+namespace {
+    double ticksToMs(int64 p_iTicks){
+        return Time::highResolutionTicksToSeconds(p_iTicks) * 1000;
+    }
+    
+    String formatTimes(const String &p_sName, const TimingCounter::Period &p_oPeriod){
+        if (p_oPeriod.m_iCount == 0){
+            return p_sName + ": -";
+        }
+        return p_sName + ": " + String(p_oPeriod.m_dAverageMs, 2) + " ms (max " + String(p_oPeriod.m_dMaxMs, 2) + ")";
+    }
+}
+
+TimingCounter::TimingCounter()
+:m_iCount(0)
+,m_iTicks(0)
+,m_iMaxTicks(0)
+{}
+
+void TimingCounter::add(){
+    ++m_iCount;
+}
+
+void TimingCounter::add(int64 p_iTicks){
+    ++m_iCount;
+    m_iTicks += p_iTicks;
+    for (int64 iMax = m_iMaxTicks.get(); p_iTicks > iMax; iMax = m_iMaxTicks.get()){
+        if (m_iMaxTicks.compareAndSetBool(p_iTicks, iMax)){
+            break;
+        }
+    }
+}
+
+TimingCounter::Period TimingCounter::take(){
+    Period oPeriod;
+    //a concurrent add() may land in either period, which is fine for a display
+    oPeriod.m_iCount = m_iCount.exchange(0);
+    const int64 iTicks = m_iTicks.exchange(0);
+    oPeriod.m_dMaxMs = ticksToMs(m_iMaxTicks.exchange(0));
+    oPeriod.m_dAverageMs = oPeriod.m_iCount > 0 ? ticksToMs(iTicks) / oPeriod.m_iCount : 0;
+    return oPeriod;
+}
+
+PerformanceOverlay::PerformanceOverlay(ProcessorPerformance &p_oProcessorPerformance)
+:m_oProcessorPerformance(p_oProcessorPerformance)
+,m_iLastUpdateMs(0)
+{
+    //we paint every pixel with an opaque background, so showing new numbers does not repaint the dome under us
+    setOpaque(true);
+    //zooming and panning the dome still work under the overlay
+    setInterceptsMouseClicks(false, false);
+    setVisible(false);
+}
+
+PerformanceOverlay::~PerformanceOverlay(){
+    m_oProcessorPerformance.setEnabled(false);
+}
+
+void PerformanceOverlay::visibilityChanged(){
+    const bool bVisible = isVisible();
+    m_oProcessorPerformance.setEnabled(bVisible);
+    if (bVisible){
+        //start from a clean period, whatever was counted before is stale
+        m_oPaint.take();
+        m_oRefresh.take();
+        m_oProcessorPerformance.m_oTick.take();
+        m_oProcessorPerformance.m_oOscSent.take();
+        m_oProcessorPerformance.m_oOscErrors.take();
+        m_iLastUpdateMs = Time::getMillisecondCounter();
+        m_asLines.clear();
+        m_asLines.add("measuring...");
+        startTimer(1000);
+    } else {
+        stopTimer();
+    }
+}
+
+void PerformanceOverlay::timerCallback(){
+    const uint32 iNowMs = Time::getMillisecondCounter();
+    const double dSeconds = jmax(1u, iNowMs - m_iLastUpdateMs) / 1000.;
+    m_iLastUpdateMs = iNowMs;
+    
+    const TimingCounter::Period oPaint     = m_oPaint.take();
+    const TimingCounter::Period oRefresh   = m_oRefresh.take();
+    const TimingCounter::Period oTick      = m_oProcessorPerformance.m_oTick.take();
+    const TimingCounter::Period oOscSent   = m_oProcessorPerformance.m_oOscSent.take();
+    const TimingCounter::Period oOscErrors = m_oProcessorPerformance.m_oOscErrors.take();
+    
+    m_asLines.clear();
+    m_asLines.add(formatTimes("paint", oPaint));
+    m_asLines.add(formatTimes("refreshGui", oRefresh));
+    m_asLines.add("fps: " + String(oPaint.m_iCount / dSeconds, 1));
+    m_asLines.add("osc: " + String(oOscSent.m_iCount / dSeconds, 0) + " msg/s, " + String(oOscErrors.m_iCount) + " errors");
+    m_asLines.add(formatTimes("processor tick", oTick));
+    repaint();
+}
+
+void PerformanceOverlay::paint(Graphics &g){
+    //must stay opaque, see setOpaque() in the constructor
+    g.fillAll(Colour(0xff202020));
+    g.setColour(Colours::white);
+    g.setFont(Font(Font::getDefaultMonospacedFontName(), 11.f, Font::plain));
+    const int iLineHeight = 14;
+    for (int iLine = 0; iLine < m_asLines.size(); ++iLine){
+        g.drawText(m_asLines[iLine], 4, 2 + iLine * iLineHeight, getWidth() - 8, iLineHeight, Justification::centredLeft, true);
+    }
+}
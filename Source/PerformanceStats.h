@@ -0,0 +1,120 @@
+/*
+ ==============================================================================
+ ZirkOSC: VST and AU audio plug-in enabling spatial movement of sound sources in a dome of speakers.
+
+ Copyright (C) 2015  GRIS-UdeM
+
+ Developers: Ludovic Laffineur, Vincent Berthiaume
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ==============================================================================
+ */
+
+
+#ifndef __ZirkOSCJUCE__PerformanceStats__
+#define __ZirkOSCJUCE__PerformanceStats__
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//! Number of events and, for timed events, their total and longest duration in high resolution ticks. Adding is a few
+//! atomic operations and never blocks, so the audio, OSC and message threads can all feed counters that the overlay reads.
+class TimingCounter {
+public:
+    TimingCounter();
+    
+    void add();
+    void add(int64 p_iTicks);
+    
+    //! what was counted since the last call, which starts a new period
+    struct Period {
+        int     m_iCount;
+        double  m_dAverageMs;
+        double  m_dMaxMs;
+    };
+    Period take();
+    
+private:
+    Atomic<int>     m_iCount;
+    Atomic<int64>   m_iTicks;
+    Atomic<int64>   m_iMaxTicks;
+};
+
+//! Adds the time spent in its scope to a counter, if enabled. When disabled it does not even read the clock.
+class ScopedPerformanceTimer {
+public:
+    ScopedPerformanceTimer(TimingCounter &p_oCounter, bool p_bEnabled)
+    :m_pCounter(p_bEnabled ? &p_oCounter : nullptr)
+    ,m_iStart(p_bEnabled ? Time::getHighResolutionTicks() : 0)
+    {}
+    ~ScopedPerformanceTimer(){
+        if (m_pCounter != nullptr){
+            m_pCounter->add(Time::getHighResolutionTicks() - m_iStart);
+        }
+    }
+private:
+    TimingCounter *m_pCounter;
+    const int64 m_iStart;
+    
+    JUCE_DECLARE_NON_COPYABLE (ScopedPerformanceTimer)
+};
+
+//! Processor side counters. They are only fed while an editor shows the performance overlay.
+struct ProcessorPerformance {
+    bool isEnabled() const {
+        return m_bEnabled.get() != 0;
+    }
+    void setEnabled(bool p_bEnabled){
+        m_bEnabled = p_bEnabled ? 1 : 0;
+    }
+    
+    //! each pass of the source update thread: constraints and OSC sending
+    TimingCounter m_oTick;
+    TimingCounter m_oOscSent;
+    TimingCounter m_oOscErrors;
+    
+private:
+    Atomic<int> m_bEnabled;
+};
+
+//! Small panel over the dome with the editor paint and refresh times, frames per second, OSC traffic and the processor
+//! tick time, updated once a second. Hidden, it runs no timer and nothing is measured; the editor and processor check
+//! isVisible() and isEnabled() before reading the clock.
+class PerformanceOverlay : public Component, private Timer {
+public:
+    PerformanceOverlay(ProcessorPerformance &p_oProcessorPerformance);
+    ~PerformanceOverlay();
+    
+    TimingCounter& getPaintCounter(){
+        return m_oPaint;
+    }
+    TimingCounter& getRefreshCounter(){
+        return m_oRefresh;
+    }
+    
+    void paint(Graphics &g) override;
+    void visibilityChanged() override;
+    
+private:
+    void timerCallback() override;
+    
+    ProcessorPerformance &m_oProcessorPerformance;
+    TimingCounter m_oPaint;
+    TimingCounter m_oRefresh;
+    uint32 m_iLastUpdateMs;
+    StringArray m_asLines;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PerformanceOverlay)
+};
+
+#endif /* defined(__ZirkOSCJUCE__PerformanceStats__) */
@@ -31,12 +31,6 @@
 
 
 
-#ifndef TIMING_TESTS
-#define TIMING_TESTS
-#endif
-#undef TIMING_TESTS
-
-
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 #include "ZirkConstants.h"
@@ -163,6 +157,12 @@ class TrajectoryTab : public Component{
     TextEditor* m_pEndAzimTextEditor;
     TextEditor* m_pEndElevTextEditor;
     TextButton* m_pResetEndButton;
+    TextButton* m_pDrawButton;
+    
+    ComboBox*   m_pLibraryComboBox;
+    TextButton* m_pLibraryLoadButton;
+    TextButton* m_pLibrarySaveButton;
+    TextButton* m_pLibraryDeleteButton;
     
     Label*      m_pTurnsLabel;
     TextEditor* m_pTurnsTextEditor;
@@ -174,6 +174,15 @@ class TrajectoryTab : public Component{
     Label*      m_pDampeningLabel;
     TextEditor* m_pDampeningTextEditor;
     
+    Label*      m_pSeedLabel;
+    TextEditor* m_pSeedTextEditor;
+    
+    Label*      m_pRandomSpeedLabel;
+    TextEditor* m_pRandomSpeedTextEditor;
+    
+    Label*      m_pRoughnessLabel;
+    TextEditor* m_pRoughnessTextEditor;
+    
     MiniProgressBar* mTrProgressBarTab;
     
     OwnedArray<Component> components;
@@ -210,6 +219,12 @@ public:
         m_pEndAzimTextEditor    = addToList(new TextEditor());
         m_pEndElevTextEditor    = addToList(new TextEditor());
         m_pResetEndButton       = addToList(new TextButton());
+        m_pDrawButton           = addToList(new TextButton());
+        
+        m_pLibraryComboBox      = addToList(new ComboBox());
+        m_pLibraryLoadButton    = addToList(new TextButton());
+        m_pLibrarySaveButton    = addToList(new TextButton());
+        m_pLibraryDeleteButton  = addToList(new TextButton());
         
         m_pTurnsLabel           = addToList (new Label());
         m_pTurnsTextEditor      = addToList (new TextEditor());
@@ -220,6 +235,15 @@ public:
         m_pDampeningLabel           = addToList (new Label());
         m_pDampeningTextEditor      = addToList (new TextEditor());
         
+        m_pSeedLabel                = addToList (new Label());
+        m_pSeedTextEditor           = addToList (new TextEditor());
+        
+        m_pRandomSpeedLabel         = addToList (new Label());
+        m_pRandomSpeedTextEditor    = addToList (new TextEditor());
+        
+        m_pRoughnessLabel           = addToList (new Label());
+        m_pRoughnessTextEditor      = addToList (new TextEditor());
+        
         
         mTrProgressBarTab       = addToList(new MiniProgressBar());
     }
@@ -243,6 +267,12 @@ public:
     TextEditor*     getEndAzimTextEditor(){ return m_pEndAzimTextEditor;}
     TextEditor*     getEndElevTextEditor(){ return m_pEndElevTextEditor;}
     TextButton*     getResetEndButton(){    return m_pResetEndButton;}
+    TextButton*     getDrawButton(){        return m_pDrawButton;}
+    
+    ComboBox*       getLibraryComboBox(){   return m_pLibraryComboBox;}
+    TextButton*     getLibraryLoadButton(){ return m_pLibraryLoadButton;}
+    TextButton*     getLibrarySaveButton(){ return m_pLibrarySaveButton;}
+    TextButton*     getLibraryDeleteButton(){return m_pLibraryDeleteButton;}
     
     Label*          getTurnsLabel(){        return m_pTurnsLabel;}
     TextEditor*     getTurnsTextEditor(){   return m_pTurnsTextEditor;}
@@ -253,6 +283,15 @@ public:
     Label*          getDampeningLabel(){        return m_pDampeningLabel;}
     TextEditor*     getDampeningTextEditor(){   return m_pDampeningTextEditor;}
     
+    Label*          getSeedLabel(){             return m_pSeedLabel;}
+    TextEditor*     getSeedTextEditor(){        return m_pSeedTextEditor;}
+    
+    Label*          getRandomSpeedLabel(){      return m_pRandomSpeedLabel;}
+    TextEditor*     getRandomSpeedTextEditor(){ return m_pRandomSpeedTextEditor;}
+    
+    Label*          getRoughnessLabel(){        return m_pRoughnessLabel;}
+    TextEditor*     getRoughnessTextEditor(){   return m_pRoughnessTextEditor;}
+    
     MiniProgressBar* getProgressBar(){      return mTrProgressBarTab;}
     
 };
@@ -264,6 +303,7 @@ class InterfaceTab : public Component{
     Label* m_pLeapState;
     Label* m_pJoystickState;
     ComboBox* m_pLeapSourceCombo;
+    ToggleButton* m_pShowPerformance;
     OwnedArray<Component> components;
     template <typename ComponentType> ComponentType* addToList (ComponentType* newComp){
         components.add (newComp);
@@ -278,7 +318,7 @@ public:
         m_pLeapState = addToList(new Label());
         m_pJoystickState = addToList(new Label());
         m_pLeapSourceCombo = addToList(new ComboBox());
-        
+        m_pShowPerformance = addToList(new ToggleButton());
     }
     
     ToggleButton* getLeapButton() {return m_pEnableLeap;}
@@ -286,9 +326,45 @@ public:
     Label* getLeapState(){return m_pLeapState;};
     Label* getJoystickState(){return m_pJoystickState;};
     ComboBox* getLeapSourceComboBox(){return m_pLeapSourceCombo;};
+    ToggleButton* getPerformanceButton(){return m_pShowPerformance;};
     
 };
 
+class SnapshotsTab : public Component{
+    
+    ComboBox*   m_pComboBox;
+    TextButton* m_pStoreButton;
+    TextButton* m_pRecallButton;
+    TextButton* m_pDeleteButton;
+    Slider*     m_pMorphSlider;
+    Label*      m_pMorphLabel;
+    OwnedArray<Component> components;
+    template <typename ComponentType> ComponentType* addToList (ComponentType* newComp){
+        components.add (newComp);
+        addAndMakeVisible (newComp);
+        return newComp;
+    }
+    
+public:
+    SnapshotsTab(){
+        m_pComboBox     = addToList(new ComboBox());
+        m_pStoreButton  = addToList(new TextButton());
+        m_pRecallButton = addToList(new TextButton());
+        m_pDeleteButton = addToList(new TextButton());
+        m_pMorphSlider  = addToList(new Slider(ZirkOSC_Morph_name));
+        m_pMorphLabel   = addToList(new Label(ZirkOSC_Morph_name));
+    }
+    
+    ComboBox*   getComboBox(){      return m_pComboBox;}
+    TextButton* getStoreButton(){   return m_pStoreButton;}
+    TextButton* getRecallButton(){  return m_pRecallButton;}
+    TextButton* getDeleteButton(){  return m_pDeleteButton;}
+    Slider*     getMorphSlider(){   return m_pMorphSlider;}
+    Label*      getMorphLabel(){    return m_pMorphLabel;}
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SnapshotsTab)
+};
+
 #define STRING2(x) #x
 #define STRING(x) STRING2(x)
 
@@ -320,12 +396,8 @@ ZirkOscAudioProcessorEditor::ZirkOscAudioProcessorEditor (ZirkOscAudioProcessor*
 ,m_oMovementConstraintComboBox("MovementConstraint")
 ,m_fHueOffset(0.125)//(0.577251)
 ,m_oEndPointLabel()
-,m_fStartPathX(-1)
-,m_fStartPathY(-1)
-,m_fEndPathX(-1)
-,m_fEndPathY(-1)
-,m_bPathJustStarted(false)
 ,m_iTrCycleCount(-1)
+,m_bIsDrawingTrajectory(false)
 {
     if (s_bUseNewGui){
         //this works, but everything is too small
@@ -410,14 +482,20 @@ ZirkOscAudioProcessorEditor::ZirkOscAudioProcessorEditor (ZirkOscAudioProcessor*
     m_oSlidersTab = new SlidersTab();
     m_oTrajectoryTab = new TrajectoryTab();
     m_oInterfaceTab = new InterfaceTab();
+    m_oSnapshotsTab = new SnapshotsTab();
+    m_oSourceListTab = new SourceListTab(ourProcessor);
     if (s_bUseNewGui){
         _TabComponent.addTab("Sliders", mGrisFeel.getBackgroundColor(), m_oSlidersTab, true);
         _TabComponent.addTab("Trajectories", mGrisFeel.getBackgroundColor(), m_oTrajectoryTab, true);
+        _TabComponent.addTab("Snapshots", mGrisFeel.getBackgroundColor(), m_oSnapshotsTab, true);
+        _TabComponent.addTab("Sources", mGrisFeel.getBackgroundColor(), m_oSourceListTab, true);
         _TabComponent.addTab("Interfaces", mGrisFeel.getBackgroundColor(), m_oInterfaceTab, true);
     
     } else {
         _TabComponent.addTab("Sliders", Colours::lightgrey, m_oSlidersTab, true);
         _TabComponent.addTab("Trajectories", Colours::lightgrey, m_oTrajectoryTab, true);
+        _TabComponent.addTab("Snapshots", Colours::lightgrey, m_oSnapshotsTab, true);
+        _TabComponent.addTab("Sources", Colours::lightgrey, m_oSourceListTab, true);
         _TabComponent.addTab("Interfaces", Colours::lightgrey, m_oInterfaceTab, true);
 
     }
@@ -502,6 +580,27 @@ ZirkOscAudioProcessorEditor::ZirkOscAudioProcessorEditor (ZirkOscAudioProcessor*
     m_pTrajectoryDampeningLabel = m_oTrajectoryTab->getDampeningLabel();
     m_pTrajectoryDampeningLabel->setText("dampening",  dontSendNotification);
     
+    //RANDOM SEED
+    m_pTrajectorySeedTextEditor = m_oTrajectoryTab->getSeedTextEditor();
+    m_pTrajectorySeedTextEditor->setText(String(ourProcessor->getRandomSeed()));
+    m_pTrajectorySeedTextEditor->addListener(this);
+    m_pTrajectorySeedLabel = m_oTrajectoryTab->getSeedLabel();
+    m_pTrajectorySeedLabel->setText("seed",  dontSendNotification);
+    
+    //RANDOM SPEED
+    m_pTrajectoryRandomSpeedTextEditor = m_oTrajectoryTab->getRandomSpeedTextEditor();
+    m_pTrajectoryRandomSpeedTextEditor->setText(String(ourProcessor->getRandomSpeed()));
+    m_pTrajectoryRandomSpeedTextEditor->addListener(this);
+    m_pTrajectoryRandomSpeedLabel = m_oTrajectoryTab->getRandomSpeedLabel();
+    m_pTrajectoryRandomSpeedLabel->setText("speed",  dontSendNotification);
+    
+    //RANDOM ROUGHNESS
+    m_pTrajectoryRoughnessTextEditor = m_oTrajectoryTab->getRoughnessTextEditor();
+    m_pTrajectoryRoughnessTextEditor->setText(String(ourProcessor->getRandomRoughness()));
+    m_pTrajectoryRoughnessTextEditor->addListener(this);
+    m_pTrajectoryRoughnessLabel = m_oTrajectoryTab->getRoughnessLabel();
+    m_pTrajectoryRoughnessLabel->setText("roughness",  dontSendNotification);
+    
     //SYNC W TEMPO TOGGLE BUTTON
     m_pSyncWTempoComboBox = m_oTrajectoryTab->getSyncWTempoComboBox();
     m_pSyncWTempoComboBox->addItem("beat(s)",      SyncWTempo);
@@ -517,6 +616,28 @@ ZirkOscAudioProcessorEditor::ZirkOscAudioProcessorEditor (ZirkOscAudioProcessor*
     m_pWriteTrajectoryButton->addListener(this);
 
     //END TRAJECTORY BUTTON
+    //DRAW TRAJECTORY BUTTON
+    m_pDrawTrajectoryButton = m_oTrajectoryTab->getDrawButton();
+    m_pDrawTrajectoryButton->setButtonText("Draw");
+    m_pDrawTrajectoryButton->setClickingTogglesState(true);
+    m_pDrawTrajectoryButton->addListener(this);
+    
+    //TRAJECTORY LIBRARY
+    m_pLibraryComboBox = m_oTrajectoryTab->getLibraryComboBox();
+    m_pLibraryComboBox->setEditableText(true);
+    m_pLibraryComboBox->setTextWhenNothingSelected("library");
+    m_pLibraryLoadButton = m_oTrajectoryTab->getLibraryLoadButton();
+    m_pLibraryLoadButton->setButtonText("Load");
+    m_pLibraryLoadButton->addListener(this);
+    m_pLibrarySaveButton = m_oTrajectoryTab->getLibrarySaveButton();
+    m_pLibrarySaveButton->setButtonText("Save");
+    m_pLibrarySaveButton->addListener(this);
+    m_pLibraryDeleteButton = m_oTrajectoryTab->getLibraryDeleteButton();
+    m_pLibraryDeleteButton->setButtonText("Delete");
+    m_pLibraryDeleteButton->addListener(this);
+    m_oTrajectoryLibrary.load(TrajectoryLibrary::getDefaultFile());
+    updateLibraryComboBox();
+    
     m_pSetEndTrajectoryButton = m_oTrajectoryTab->getEndButton();
     m_pSetEndTrajectoryButton->setButtonText("Set end point");
     m_pSetEndTrajectoryButton->setClickingTogglesState(true);
@@ -546,6 +667,27 @@ ZirkOscAudioProcessorEditor::ZirkOscAudioProcessorEditor (ZirkOscAudioProcessor*
     mTrProgressBar = m_oTrajectoryTab->getProgressBar();
     mTrProgressBar->setVisible(false);
     
+    //---------- SNAPSHOTS ----------
+    m_pSnapshotComboBox = m_oSnapshotsTab->getComboBox();
+    m_pSnapshotComboBox->setEditableText(true);
+    m_pSnapshotComboBox->setTextWhenNothingSelected("snapshot");
+    m_pSnapshotStoreButton = m_oSnapshotsTab->getStoreButton();
+    m_pSnapshotStoreButton->setButtonText("Store");
+    m_pSnapshotStoreButton->addListener(this);
+    m_pSnapshotRecallButton = m_oSnapshotsTab->getRecallButton();
+    m_pSnapshotRecallButton->setButtonText("Recall");
+    m_pSnapshotRecallButton->addListener(this);
+    m_pSnapshotDeleteButton = m_oSnapshotsTab->getDeleteButton();
+    m_pSnapshotDeleteButton->setButtonText("Delete");
+    m_pSnapshotDeleteButton->addListener(this);
+    updateSnapshotComboBox();
+    
+    m_pMorphSlider = m_oSnapshotsTab->getMorphSlider();
+    m_pMorphLabel  = m_oSnapshotsTab->getMorphLabel();
+    setSliderAndLabel("Morph", m_pMorphSlider, m_pMorphLabel, 0, 1);
+    m_pMorphSlider->setValue(ourProcessor->getParameter(ZirkOscAudioProcessor::ZirkOSC_Morph_ParamId), dontSendNotification);
+    m_pMorphSlider->addListener(this);
+    
     //---------- INTERFACES ----------
     //JOYSTICK INFOS LABEL
     m_pLBJoystickState = m_oInterfaceTab->getJoystickState();
@@ -556,6 +698,12 @@ ZirkOscAudioProcessorEditor::ZirkOscAudioProcessorEditor (ZirkOscAudioProcessor*
     m_pTBEnableJoystick->addListener(this);
     m_pTBEnableJoystick->setToggleState(false,dontSendNotification);
     
+    //PERFORMANCE OVERLAY TOGGLE BUTTON
+    m_pTBShowPerformance = m_oInterfaceTab->getPerformanceButton();
+    m_pTBShowPerformance->setButtonText("Show performance");
+    m_pTBShowPerformance->addListener(this);
+    m_pTBShowPerformance->setToggleState(false,dontSendNotification);
+    
     
     //LEAP MOTION TOGGLE BUTTON
     m_pTBEnableLeap = m_oInterfaceTab->getLeapButton();
@@ -577,6 +725,9 @@ ZirkOscAudioProcessorEditor::ZirkOscAudioProcessorEditor (ZirkOscAudioProcessor*
     m_pCBLeapSource->setSelectedId(ourProcessor->getSelectedSource());
     m_pCBLeapSource->addListener(this);
 
+    //---------- PERFORMANCE OVERLAY ----------
+    addChildComponent(m_pPerformanceOverlay = new PerformanceOverlay(ourProcessor->getPerformance()));
+    
     //---------- RESIZABLE CORNER ----------
     // add the triangular resizer component for the bottom-right of the UI
     addAndMakeVisible (_Resizer = new ResizableCornerComponent (this, &_ResizeLimits));
@@ -597,7 +748,10 @@ ZirkOscAudioProcessorEditor::ZirkOscAudioProcessorEditor (ZirkOscAudioProcessor*
 //    }
     
     this->setFocusContainer(true);
-    startEditorTimer(ZirkOSC_reg_timerDelay);    
+    //moves made while the editor was closed are not part of the trail
+    ourProcessor->getPositionTrace().discard();
+    ourProcessor->getGuiRefreshBroadcaster().addChangeListener(this);
+    m_pFrameTicker->requestFrame(this);
 }
 
 void ZirkOscAudioProcessorEditor::updateConstraintCombo(){
@@ -621,12 +775,9 @@ void ZirkOscAudioProcessorEditor::updateConstraintCombo(){
     m_oMovementConstraintComboBox.setSelectedId(selected_id);
 }
 
-void ZirkOscAudioProcessorEditor::startEditorTimer(int intervalInMilliseconds){
-    Timer::startTimer (intervalInMilliseconds);
-}
-
 ZirkOscAudioProcessorEditor::~ZirkOscAudioProcessorEditor() {
-    //stopTimer();
+    ourProcessor->getGuiRefreshBroadcaster().removeChangeListener(this);
+    m_pFrameTicker->cancelFrame(this);
     if(m_pTBEnableJoystick->getToggleState())
     {
         IOHIDManagerUnscheduleFromRunLoop(gIOHIDManagerRef, CFRunLoopGetCurrent(), kCFRunLoopDefaultMode);
@@ -707,6 +858,24 @@ void ZirkOscAudioProcessorEditor::updateTrajectoryComponents(){
         m_pTrajectoryDeviationLabel->setVisible(false);
         m_pTrajectoryDeviationTextEditor->setVisible(false);
     }
+    
+    m_pDrawTrajectoryButton->setVisible(iSelectedTrajectory == Drawn);
+    
+    if (iSelectedTrajectory == AllTrajectoryTypes::Random){
+        m_pTrajectorySeedTextEditor->setVisible(true);
+        m_pTrajectorySeedLabel->setVisible(true);
+        m_pTrajectoryRandomSpeedTextEditor->setVisible(true);
+        m_pTrajectoryRandomSpeedLabel->setVisible(true);
+        m_pTrajectoryRoughnessTextEditor->setVisible(true);
+        m_pTrajectoryRoughnessLabel->setVisible(true);
+    } else {
+        m_pTrajectorySeedTextEditor->setVisible(false);
+        m_pTrajectorySeedLabel->setVisible(false);
+        m_pTrajectoryRandomSpeedTextEditor->setVisible(false);
+        m_pTrajectoryRandomSpeedLabel->setVisible(false);
+        m_pTrajectoryRoughnessTextEditor->setVisible(false);
+        m_pTrajectoryRoughnessLabel->setVisible(false);
+    }
 }
 
 void ZirkOscAudioProcessorEditor::setDefaultPendulumEndpoint(){
@@ -730,6 +899,9 @@ void ZirkOscAudioProcessorEditor::resized() {
 
     ourProcessor->setLastUiWidth(iCurWidth);
     ourProcessor->setLastUiHeight(iCurHeight);
+    
+    m_oBackgroundImage = Image::null;
+    m_oSourceAtlas = Image::null;
 
     _Resizer->setBounds (iCurWidth - 16, iCurHeight - 16, 16, 16);
     
@@ -744,6 +916,7 @@ void ZirkOscAudioProcessorEditor::resized() {
     
     //------------ LABELS ON RIGHT SIDE +version label------------
     m_logoImage.setBounds(5,5,55,55);
+    m_pPerformanceOverlay->setBounds(5,65,240,76);
     m_VersionLabel.setBounds        (iCurWidth-180,5,100,30);
     setLabelAndTextEditorPosition   (iCurWidth-80, 5,   80, 25, &m_oNbrSourceLabel, &_NbrSourceTextEditor);
     setLabelAndTextEditorPosition   (iCurWidth-80, 55,  80, 25, &m_oFirstSourceIdLabel, &_FirstSourceIdTextEditor);
@@ -773,42 +946,53 @@ void ZirkOscAudioProcessorEditor::resized() {
     //------------ TRAJECTORIES TAB------------
     updateTrajectoryTabSize(iCurWidth, iCurHeight);
     
+    //------------ SNAPSHOTS TAB ------------
+    m_pSnapshotComboBox->               setBounds(kiLM,       kiTM,     200, 25);
+    m_pSnapshotStoreButton->            setBounds(kiLM+200,   kiTM,     60,  25);
+    m_pSnapshotRecallButton->           setBounds(kiLM+260,   kiTM,     60,  25);
+    m_pSnapshotDeleteButton->           setBounds(kiLM+320,   kiTM,     60,  25);
+    setSliderAndLabelPosition(kiLM, kiTM+40, iCurWidth-40, 20, m_pMorphSlider, m_pMorphLabel);
+    
     //------------ INTERFACES TAB ------------
     m_pTBEnableLeap->                   setBounds(kiLM,       kiTM,     100, 25);
     m_pCBLeapSource->                   setBounds(kiLM,       kiTM+25,  100, 25);
     m_pTBEnableJoystick->               setBounds(kiLM,       kiTM+50,  100, 25);
     m_pLBLeapState->                    setBounds(kiLM+100,   kiTM,     200, 25);
     m_pLBJoystickState->                setBounds(kiLM+100,   kiTM+50,  200, 25);
+    m_pTBShowPerformance->              setBounds(kiLM,       kiTM+75,  150, 25);
 }
 
 void ZirkOscAudioProcessorEditor::updateWallCircleSize(int iCurWidth, int iCurHeight){
-    //------------ SAVE SOURCE ELEVATION ---------------
-    float fAllElev01[8];
-    for (int iCurSrc = 0; iCurSrc < ourProcessor->getNbrSources(); ++iCurSrc){
-        fAllElev01[iCurSrc] = ourProcessor->getSources()[iCurSrc].getElevation01();
-    }
     //------------ WALLCIRCLE ------------
     _ZirkOSC_Center_X = (iCurWidth - 80)/2;
     _ZirkOSC_Center_Y = (iCurHeight-ZirkOSC_SlidersGroupHeight)/2;
     //assign smallest possible radius
     int iXRadius = (iCurWidth -85 -kiSrcDiameter)/2;
     int iYRadius = (iCurHeight-ZirkOSC_SlidersGroupHeight-10)/2;
+    //source positions are stored in dome coordinates, so they are not affected by the new radius
+    m_iDomeRadius = iXRadius <= iYRadius ? iXRadius: iYRadius;
     
-    
-    ourProcessor->setIsRecordingAutomation(true);   //not sure if this does anything, but better safe than sorry
-    ZirkOscAudioProcessor::s_iDomeRadius = iXRadius <= iYRadius ? iXRadius: iYRadius;
-    ourProcessor->updatePositions();
-    ourProcessor->setIsRecordingAutomation(false);
-    
+    //zoom and pan, with the zoomed dome always covering the area of the whole one
+    const float fMaxPan = m_iDomeRadius * (m_fZoom - 1);
+    m_oPan.setXY(jlimit(-fMaxPan, fMaxPan, m_oPan.x), jlimit(-fMaxPan, fMaxPan, m_oPan.y));
+    m_iDomeRadius = roundToInt(m_iDomeRadius * m_fZoom);
+    _ZirkOSC_Center_X += roundToInt(m_oPan.x);
+    _ZirkOSC_Center_Y += roundToInt(m_oPan.y);
     
     int w = 250;
-    m_oEndPointLabel.setBounds(_ZirkOSC_Center_X-w/2, _ZirkOSC_Center_Y+ZirkOscAudioProcessor::s_iDomeRadius, w, 15);
+    m_oEndPointLabel.setBounds(_ZirkOSC_Center_X-w/2, _ZirkOSC_Center_Y+m_iDomeRadius, w, 15);
     m_oEndPointLabel.setVisible(false);
-    //------------ RESTORE SOURCE ELEVATION ---------------
-    for (int iCurSrc = 0; iCurSrc < ourProcessor->getNbrSources(); ++iCurSrc){
-        ourProcessor->getSources()[iCurSrc].setElevation01(fAllElev01[iCurSrc]);
-    }
 }
+Rectangle<int> ZirkOscAudioProcessorEditor::getDomeViewBounds() const {
+    return Rectangle<int>(0, 0, getWidth(), getHeight() - ZirkOSC_SlidersGroupHeight + ZirkOSC_ConstraintComboBoxHeight);
+}
+
+void ZirkOscAudioProcessorEditor::updateDomeView(){
+    updateWallCircleSize(getWidth(), getHeight());
+    m_oBackgroundImage = Image::null;
+    repaint();
+}
+
 void ZirkOscAudioProcessorEditor::updateTrajectoryTabSize(int iCurWidth, int iCurHeight){
     int iCol1w = 90, iCol2w = 140, iCol3w = 80, iCol4w = 110, iRowH = 25;
     //row 1                                       x                                 y               width           height
@@ -818,6 +1002,8 @@ void ZirkOscAudioProcessorEditor::updateTrajectoryTabSize(int iCurWidth, int iCu
     //row 1 col 3.5 and 4 are either of these things
     m_pTrajectoryDeviationTextEditor->  setBounds(kiLM+iCol1w+iCol2w + iCol3w,      kiTM,           30,             iRowH);
     m_pTrajectoryDeviationLabel->       setBounds(kiLM+iCol1w+iCol2w + iCol3w+30,   kiTM,           iCol4w-30,      iRowH);
+    m_pTrajectoryRandomSpeedTextEditor->setBounds(kiLM+iCol1w+iCol2w + iCol3w,      kiTM,           30,             iRowH);
+    m_pTrajectoryRandomSpeedLabel->     setBounds(kiLM+iCol1w+iCol2w + iCol3w+30,   kiTM,           iCol4w-30,      iRowH);
     updateTurnsWidgetLocation();
     //row 2
     m_pTrajectoryDurationTextEditor->   setBounds(kiLM,                             kiTM+iRowH,     iCol1w,         iRowH);
@@ -825,14 +1011,24 @@ void ZirkOscAudioProcessorEditor::updateTrajectoryTabSize(int iCurWidth, int iCu
     m_pTrajectoryDurationLabel->        setBounds(kiLM+iCol1w + 3*iCol2w/4,         kiTM+iRowH,     iCol3w,         iRowH);
     m_pTrajectoryDampeningTextEditor->  setBounds(kiLM+iCol1w+iCol2w + iCol3w,      kiTM+iRowH,     30,             iRowH);
     m_pTrajectoryDampeningLabel->       setBounds(kiLM+iCol1w+iCol2w + iCol3w+30,   kiTM+iRowH,     iCol4w-30,      iRowH);
+    m_pTrajectoryRoughnessTextEditor->  setBounds(kiLM+iCol1w+iCol2w + iCol3w,      kiTM+iRowH,     30,             iRowH);
+    m_pTrajectoryRoughnessLabel->       setBounds(kiLM+iCol1w+iCol2w + iCol3w+30,   kiTM+iRowH,     iCol4w-30,      iRowH);
     //row3
     m_pTrajectoryCountTextEditor->      setBounds(kiLM,                             kiTM+2*iRowH,   iCol1w,         iRowH);
     m_pTrajectoryCountLabel->           setBounds(kiLM+iCol1w,                      kiTM+2*iRowH,   iCol2w/2,       iRowH);
+    m_pTrajectorySeedTextEditor->       setBounds(kiLM+iCol1w+iCol2w + iCol3w,      kiTM+2*iRowH,   60,             iRowH);
+    m_pTrajectorySeedLabel->            setBounds(kiLM+iCol1w+iCol2w + iCol3w+60,   kiTM+2*iRowH,   iCol4w-60,      iRowH);
     //row 4: end location
     m_pSetEndTrajectoryButton->         setBounds(kiLM,                             kiTM+3*iRowH,   iCol1w,         iRowH);
+    m_pDrawTrajectoryButton->           setBounds(kiLM,                             kiTM+3*iRowH,   iCol1w,         iRowH);
     m_pEndAzimTextEditor->              setBounds(kiLM+iCol1w,                      kiTM+3*iRowH,   iCol2w/2,       iRowH);
     m_pEndElevTextEditor->              setBounds(kiLM+iCol1w + iCol2w/2,           kiTM+3*iRowH,   iCol2w/2,       iRowH);
     m_pResetEndTrajectoryButton->       setBounds(kiLM+iCol1w + iCol2w,             kiTM+3*iRowH,   iCol3w,         iRowH);
+    //row 6: library
+    m_pLibraryComboBox->                setBounds(kiLM,                             kiTM+5*iRowH,   iCol1w+iCol2w/2,iRowH);
+    m_pLibraryLoadButton->              setBounds(kiLM+iCol1w + iCol2w/2,           kiTM+5*iRowH,   iCol3w*3/4,     iRowH);
+    m_pLibrarySaveButton->              setBounds(kiLM+iCol1w + iCol2w/2+iCol3w*3/4,kiTM+5*iRowH,   iCol3w*3/4,     iRowH);
+    m_pLibraryDeleteButton->            setBounds(kiLM+iCol1w + iCol2w/2+iCol3w*3/2,kiTM+5*iRowH,   iCol3w*3/4,     iRowH);
     //row 5: write and progress bar line
     m_pWriteTrajectoryButton->          setBounds(iCurWidth-105, 125, 100, iRowH);
     mTrProgressBar->                    setBounds(iCurWidth-210, 125, 100, iRowH);
@@ -875,13 +1071,13 @@ void ZirkOscAudioProcessorEditor::setLabelAndTextEditorPosition(int x, int y, in
 }
 
 void ZirkOscAudioProcessorEditor::paint (Graphics& g){
-    if (s_bUseNewGui){
-        g.fillAll (mGrisFeel.getBackgroundColor());
+    ScopedPerformanceTimer oTimer(m_pPerformanceOverlay->getPaintCounter(), m_pPerformanceOverlay->isVisible());
+    if (m_bBackgroundCacheEnabled){
+        drawCachedBackground(g);
     } else {
-        g.fillAll (Colours::lightgrey);
+        paintBackground(g);
     }
-    paintWallCircle(g);     //this is the big, main circle in the gui
-    paintCoordLabels(g);
+    g.reduceClipRegion(getDomeViewBounds());
     paintCenterDot(g);
     for (int iCurSrc = 0; iCurSrc < ourProcessor->getNbrSources(); ++iCurSrc) {
         paintSpanArc(g, iCurSrc);
@@ -893,123 +1089,292 @@ void ZirkOscAudioProcessorEditor::paint (Graphics& g){
     g.setColour(Colour::fromHSV(hue, 1, 1, 0.8f));
     float fX, fY;
     ourProcessor->getSources()[iSelectedSrc].getXY(fX, fY);
+    fX *= m_iDomeRadius;
+    fY *= m_iDomeRadius;
     g.drawLine(_ZirkOSC_Center_X, _ZirkOSC_Center_Y, _ZirkOSC_Center_X + fX, _ZirkOSC_Center_Y + fY );
     float radiusZenith = sqrtf(fX*fX + fY*fY);
     g.drawEllipse(_ZirkOSC_Center_X-radiusZenith, _ZirkOSC_Center_Y-radiusZenith, radiusZenith*2, radiusZenith*2, 1.0);
+    paintDrawnTrajectory(g);
     //draw sources
     paintSourcePoint(g);
-    if (m_fStartPathX != -1 && m_fEndPathX != -1){
-        if (m_bPathJustStarted){
-            m_oTrajectoryPath.startNewSubPath (m_fStartPathX, m_fStartPathY);
-            m_bPathJustStarted = false;
+    m_oPositionTrail.paint(g, Point<float>(_ZirkOSC_Center_X, _ZirkOSC_Center_Y), m_iDomeRadius, Colour(0, 102, 255), Time::getMillisecondCounter());
+}
+
+void ZirkOscAudioProcessorEditor::paintBackground (Graphics& g){
+    if (s_bUseNewGui){
+        g.fillAll (mGrisFeel.getBackgroundColor());
+    } else {
+        g.fillAll (Colours::lightgrey);
+    }
+    //a zoomed dome must not spill under the tabs
+    Graphics::ScopedSaveState oState(g);
+    g.reduceClipRegion(getDomeViewBounds());
+    paintWallCircle(g);     //this is the big, main circle in the gui
+    paintCoordLabels(g);
+}
+
+void ZirkOscAudioProcessorEditor::drawCachedBackground (Graphics& g){
+    //render at the physical pixel scale, so the cached layer stays sharp on retina screens
+    const float fScale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    const int iWidth  = roundToInt(getWidth()  * fScale);
+    const int iHeight = roundToInt(getHeight() * fScale);
+    if (iWidth <= 0 || iHeight <= 0){
+        return;
+    }
+    if (m_oBackgroundImage.isNull() || m_fBackgroundScale != fScale || m_oBackgroundImage.getWidth() != iWidth || m_oBackgroundImage.getHeight() != iHeight){
+        m_oBackgroundImage = Image(Image::RGB, iWidth, iHeight, false);
+        m_fBackgroundScale = fScale;
+        Graphics oImageGraphics(m_oBackgroundImage);
+        oImageGraphics.addTransform(AffineTransform::scale(fScale));
+        paintBackground(oImageGraphics);
+    }
+    g.drawImageTransformed(m_oBackgroundImage, AffineTransform::scale(1 / fScale));
+}
+
+void ZirkOscAudioProcessorEditor::lookAndFeelChanged(){
+    m_oBackgroundImage = Image::null;
+    m_oSourceAtlas = Image::null;
+    repaint();
+}
+
+void ZirkOscAudioProcessorEditor::paintDrawnTrajectory (Graphics& g){
+    const float fRadius = m_iDomeRadius;
+    Path oPath;
+    if (m_bIsDrawingTrajectory){
+        //raw points while recording
+        for (int i = 0; i < m_oRecordingSpline.getNumPoints(); ++i){
+            Point<float> oPoint = m_oRecordingSpline.getPoint(i) * fRadius;
+            i == 0 ? oPath.startNewSubPath(_ZirkOSC_Center_X + oPoint.x, _ZirkOSC_Center_Y + oPoint.y) : oPath.lineTo(_ZirkOSC_Center_X + oPoint.x, _ZirkOSC_Center_Y + oPoint.y);
+        }
+    } else if (ourProcessor->getSelectedTrajectory() == Drawn && !ourProcessor->getDrawnSpline().isEmpty()){
+        const TrajectorySpline &oSpline = ourProcessor->getDrawnSpline();
+        const int iSteps = 100;
+        for (int i = 0; i <= iSteps; ++i){
+            Point<float> oPoint = oSpline.getPointAtDistance01(static_cast<float>(i) / iSteps) * fRadius;
+            i == 0 ? oPath.startNewSubPath(_ZirkOSC_Center_X + oPoint.x, _ZirkOSC_Center_Y + oPoint.y) : oPath.lineTo(_ZirkOSC_Center_X + oPoint.x, _ZirkOSC_Center_Y + oPoint.y);
         }
-        m_oTrajectoryPath.lineTo (m_fEndPathX, m_fEndPathY);
-        g.setColour(Colour(0, 102, 255));
-        g.strokePath (m_oTrajectoryPath, PathStrokeType (2.0f, PathStrokeType::JointStyle::curved));
+    } else {
+        return;
     }
+    g.setColour(Colour(0, 102, 255).withAlpha(.5f));
+    g.strokePath (oPath, PathStrokeType (1.5f, PathStrokeType::JointStyle::curved));
 }
 
 //Drawing Span Arc
 void ZirkOscAudioProcessorEditor::paintSpanArc (Graphics& g, int iSrc){
-    float HRElevSpan = PercentToHR(ourProcessor->getSources()[iSrc].getElevationSpan(), ZirkOSC_ElevSpan_Min, ZirkOSC_ElevSpan_Max);
-    float HRAzimSpan = PercentToHR(ourProcessor->getSources()[iSrc].getAzimuthSpan(), ZirkOSC_AzimSpan_Min, ZirkOSC_AzimSpan_Max);
+    SoundSource &oSource = ourProcessor->getSources()[iSrc];
     
     //return if there is no span arc to paint
-    if (HRElevSpan == 0.f && HRAzimSpan == 0.f){
+    if (oSource.getElevationSpan() == 0.f && oSource.getAzimuthSpan() == 0.f){
         return;
     }
     
-    //get current azim+elev in angles
-    float HRAzim = PercentToHR(ourProcessor->getSources()[iSrc].getAzimuth01()  , ZirkOSC_Azim_Min, ZirkOSC_Azim_Max);
-    float HRElev = PercentToHR(ourProcessor->getSources()[iSrc].getElevation01(), ZirkOSC_Elev_Min, ZirkOSC_Elev_Max);
-    
-    //calculate max and min elevation in degrees
-    Point<float> maxElev = {HRAzim, HRElev+HRElevSpan/2};
-    Point<float> minElev = {HRAzim, HRElev-HRElevSpan/2};
-    
-    if(minElev.getY() < ZirkOSC_ElevSpan_Min){
-        maxElev.setY(maxElev.getY()+ ZirkOSC_ElevSpan_Min-minElev.getY());
-        minElev.setY(ZirkOSC_ElevSpan_Min);
-    }
-    
-    //convert max min elev to xy
-    Point<float> screenMaxElev = degreeToXy(maxElev);
-    Point<float> screenMinElev = degreeToXy(minElev);
-    
-    //form minmax elev, calculate minmax radius
-    float maxRadius = sqrtf(screenMaxElev.getX()*screenMaxElev.getX() + screenMaxElev.getY()*screenMaxElev.getY());
-    float minRadius = sqrtf(screenMinElev.getX()*screenMinElev.getX() + screenMinElev.getY()*screenMinElev.getY());
-    
-    //drawing the path for spanning
-    Path myPath;
-    float x = screenMinElev.getX();
-    float y = screenMinElev.getY();
-    myPath.startNewSubPath(_ZirkOSC_Center_X+x,_ZirkOSC_Center_Y+y);
-    
-    //half first arc center
-    myPath.addCentredArc(_ZirkOSC_Center_X, _ZirkOSC_Center_Y, minRadius, minRadius, 0.0, degreeToRadian(-HRAzim), degreeToRadian(-HRAzim + HRAzimSpan/2 ));
-    
-    if (maxElev.getY()> ZirkOSC_ElevSpan_Max) { // if we are over the top of the dome we draw the adjacent angle
-        myPath.addCentredArc(_ZirkOSC_Center_X, _ZirkOSC_Center_Y, maxRadius, maxRadius, 0.0, M_PI+degreeToRadian(-HRAzim + HRAzimSpan/2), M_PI+degreeToRadian(-HRAzim - HRAzimSpan/2));
-    } else {
-        myPath.addCentredArc(_ZirkOSC_Center_X, _ZirkOSC_Center_Y, maxRadius, maxRadius, 0.0, degreeToRadian(-HRAzim+HRAzimSpan/2), degreeToRadian(-HRAzim-HRAzimSpan/2));
+    SpanArcGeometry &oArc = m_aSpanArcs[iSrc];
+    if (oArc.m_fAzim01 != oSource.getAzimuth01() || oArc.m_fElev01 != oSource.getElevation01() || oArc.m_fAzimSpan01 != oSource.getAzimuthSpan()
+        || oArc.m_fElevSpan01 != oSource.getElevationSpan() || oArc.m_iDomeRadius != m_iDomeRadius || oArc.m_iCenterX != _ZirkOSC_Center_X || oArc.m_iCenterY != _ZirkOSC_Center_Y){
+        
+        oArc.m_fAzim01      = oSource.getAzimuth01();
+        oArc.m_fElev01      = oSource.getElevation01();
+        oArc.m_fAzimSpan01  = oSource.getAzimuthSpan();
+        oArc.m_fElevSpan01  = oSource.getElevationSpan();
+        oArc.m_iDomeRadius  = m_iDomeRadius;
+        oArc.m_iCenterX     = _ZirkOSC_Center_X;
+        oArc.m_iCenterY     = _ZirkOSC_Center_Y;
+        
+        float HRElevSpan = PercentToHR(oArc.m_fElevSpan01, ZirkOSC_ElevSpan_Min, ZirkOSC_ElevSpan_Max);
+        float HRAzimSpan = PercentToHR(oArc.m_fAzimSpan01, ZirkOSC_AzimSpan_Min, ZirkOSC_AzimSpan_Max);
+        
+        //get current azim+elev in angles
+        float HRAzim = PercentToHR(oArc.m_fAzim01, ZirkOSC_Azim_Min, ZirkOSC_Azim_Max);
+        float HRElev = PercentToHR(oArc.m_fElev01, ZirkOSC_Elev_Min, ZirkOSC_Elev_Max);
+        
+        //calculate max and min elevation in degrees
+        Point<float> maxElev = {HRAzim, HRElev+HRElevSpan/2};
+        Point<float> minElev = {HRAzim, HRElev-HRElevSpan/2};
+        
+        if(minElev.getY() < ZirkOSC_ElevSpan_Min){
+            maxElev.setY(maxElev.getY()+ ZirkOSC_ElevSpan_Min-minElev.getY());
+            minElev.setY(ZirkOSC_ElevSpan_Min);
+        }
+        
+        //convert max min elev to xy
+        Point<float> screenMaxElev = degreeToXy(maxElev);
+        Point<float> screenMinElev = degreeToXy(minElev);
+        
+        //form minmax elev, calculate minmax radius
+        float maxRadius = sqrtf(screenMaxElev.getX()*screenMaxElev.getX() + screenMaxElev.getY()*screenMaxElev.getY());
+        float minRadius = sqrtf(screenMinElev.getX()*screenMinElev.getX() + screenMinElev.getY()*screenMinElev.getY());
+        
+        //drawing the path for spanning
+        Path &myPath = oArc.m_oArea;
+        myPath.clear();
+        float x = screenMinElev.getX();
+        float y = screenMinElev.getY();
+        myPath.startNewSubPath(_ZirkOSC_Center_X+x,_ZirkOSC_Center_Y+y);
+        
+        //half first arc center
+        myPath.addCentredArc(_ZirkOSC_Center_X, _ZirkOSC_Center_Y, minRadius, minRadius, 0.0, degreeToRadian(-HRAzim), degreeToRadian(-HRAzim + HRAzimSpan/2 ));
+        
+        if (maxElev.getY()> ZirkOSC_ElevSpan_Max) { // if we are over the top of the dome we draw the adjacent angle
+            myPath.addCentredArc(_ZirkOSC_Center_X, _ZirkOSC_Center_Y, maxRadius, maxRadius, 0.0, M_PI+degreeToRadian(-HRAzim + HRAzimSpan/2), M_PI+degreeToRadian(-HRAzim - HRAzimSpan/2));
+        } else {
+            myPath.addCentredArc(_ZirkOSC_Center_X, _ZirkOSC_Center_Y, maxRadius, maxRadius, 0.0, degreeToRadian(-HRAzim+HRAzimSpan/2), degreeToRadian(-HRAzim-HRAzimSpan/2));
+        }
+        myPath.addCentredArc(_ZirkOSC_Center_X, _ZirkOSC_Center_Y, minRadius, minRadius, 0.0, degreeToRadian(-HRAzim-HRAzimSpan/2), degreeToRadian(-HRAzim));
+        myPath.closeSubPath();
+        
+        PathStrokeType(2.5).createStrokedPath(oArc.m_oOutline, myPath);
     }
-    myPath.addCentredArc(_ZirkOSC_Center_X, _ZirkOSC_Center_Y, minRadius, minRadius, 0.0, degreeToRadian(-HRAzim-HRAzimSpan/2), degreeToRadian(-HRAzim));
-    myPath.closeSubPath();
     
     float hue = (float)iSrc / 8 + m_fHueOffset;
     if (hue > 1) hue -= 1;
     g.setColour(Colour::fromHSV(hue, 1, 1, 0.1));
-    g.fillPath(myPath);
+    g.fillPath(oArc.m_oArea);
     g.setColour(Colour::fromHSV(hue, 1, 1, 0.5));
-    PathStrokeType strokeType = PathStrokeType(2.5);
-    g.strokePath(myPath, strokeType);
+    g.fillPath(oArc.m_oOutline);
 }
 
 void ZirkOscAudioProcessorEditor::paintSourcePoint (Graphics& g){
-    float fX, fY;
+    //the atlas is rendered at the physical pixel scale, so markers stay sharp on retina screens
+    const float fScale = g.getInternalContext().getPhysicalPixelScaleFactor();
+    const int iCell = roundToInt(kiSrcSpriteSize * fScale);
+    if (m_oSourceAtlas.isNull() || m_fSourceAtlasScale != fScale){
+        m_oSourceAtlas = Image(Image::ARGB, 2 * iCell, ZirkOSC_Max_Sources * iCell, true);
+        m_fSourceAtlasScale = fScale;
+        for (int i = 0; i < ZirkOSC_Max_Sources; ++i){
+            m_aSourceAtlasId[i] = -1;
+        }
+    }
+    
+    updateSourceHitGrid();
+    
+    //sources whose markers fall in the same screen cell are drawn as one marker with their count, so the cost of a frame
+    //follows the number of visible markers. Each cluster is drawn where its first source is
+    int aClusterCells[ZirkOSC_Max_Sources], aClusterCounts[ZirkOSC_Max_Sources], aClusterFirsts[ZirkOSC_Max_Sources];
+    int aSourceStates[ZirkOSC_Max_Sources];
+    Point<float> aSourcePositions[ZirkOSC_Max_Sources];
+    int iNbrClusters = 0;
+    
     for (int i=0; i<ourProcessor->getNbrSources(); ++i) {
-        
-        ourProcessor->getSources()[i].getXY(fX, fY);
         //----------------------------------------------------------------------------------------------
         float hue = (float)i / 8 + m_fHueOffset;
 
         if (hue > 1) hue -= 1;
         
-        //---- draw source point
-        //fill source point
-        g.setColour(Colour::fromHSV(hue, 1, 1, 1));
+        int iId = ourProcessor->getSources()[i].getSourceId();
+        if (m_aSourceAtlasId[i] != iId || m_aSourceAtlasHue[i] != hue){
+            renderSourceSprites(i, hue, iId);
+        }
         
-        float fCurR = hypotf(fX, fY);
-        if ( fCurR > ZirkOscAudioProcessor::s_iDomeRadius+5){
-            float fExtraRatio = ZirkOscAudioProcessor::s_iDomeRadius / fCurR;
-            
-            g.setColour(Colours::grey);
-            
-            fX *= fExtraRatio;
-            fY *= fExtraRatio;
+        //sources outside of the dome are drawn in grey on its edge
+        bool bOutside;
+        const Point<float> oOffset = getSourceMarkerOffset(i, bOutside);
+        aSourceStates[i]    = bOutside ? 1 : 0;
+        aSourcePositions[i] = Point<float>(_ZirkOSC_Center_X, _ZirkOSC_Center_Y) + oOffset;
+        
+        const int iScreenCell = static_cast<int>(floorf(aSourcePositions[i].y / kiSrcSpriteSize)) * 65536 + static_cast<int>(floorf(aSourcePositions[i].x / kiSrcSpriteSize));
+        int iCluster = 0;
+        while (iCluster < iNbrClusters && aClusterCells[iCluster] != iScreenCell){
+            ++iCluster;
+        }
+        if (iCluster == iNbrClusters){
+            aClusterCells[iCluster]  = iScreenCell;
+            aClusterCounts[iCluster] = 0;
+            aClusterFirsts[iCluster] = i;
+            ++iNbrClusters;
+        }
+        ++aClusterCounts[iCluster];
+    }
+    
+    const Rectangle<int> oClip = g.getClipBounds();
+    for (int iCluster = 0; iCluster < iNbrClusters; ++iCluster){
+        const int i = aClusterFirsts[iCluster];
+        const Rectangle<int> oMarker(roundToInt(aSourcePositions[i].x - kiSrcSpriteSize / 2.f), roundToInt(aSourcePositions[i].y - kiSrcSpriteSize / 2.f),
+                                     kiSrcSpriteSize, kiSrcSpriteSize);
+        if (!oClip.intersects(oMarker)){
+            continue;
+        }
+        if (aClusterCounts[iCluster] == 1){
+            g.drawImage(m_oSourceAtlas, oMarker.getX(), oMarker.getY(), kiSrcSpriteSize, kiSrcSpriteSize, aSourceStates[i] * iCell, i * iCell, iCell, iCell);
+        } else {
+            const Rectangle<float> oCircle = oMarker.toFloat().reduced(1);
+            g.setColour(Colours::white);
+            g.fillEllipse(oCircle);
+            g.setColour(Colours::red);
+            g.drawEllipse(oCircle, 1);
+            g.setColour(Colours::black);
+            g.drawText(String(aClusterCounts[iCluster]), oMarker, Justification(Justification::centred), false);
         }
+    }
+}
+
+Point<float> ZirkOscAudioProcessorEditor::getSourceMarkerOffset (int iSrc, bool &bOutside){
+    float fX, fY;
+    ourProcessor->getSources()[iSrc].getXY(fX, fY);
+    fX *= m_iDomeRadius;
+    fY *= m_iDomeRadius;
+    float fCurR = hypotf(fX, fY);
+    bOutside = fCurR > m_iDomeRadius+5;
+    if (bOutside){
+        float fExtraRatio = m_iDomeRadius / fCurR;
+        fX *= fExtraRatio;
+        fY *= fExtraRatio;
+    }
+    return Point<float>(fX, fY);
+}
+
+void ZirkOscAudioProcessorEditor::updateSourceHitGrid(){
+    if (m_oSourceHitGrid.getDomeRadius() != m_iDomeRadius){
+        m_oSourceHitGrid.reset(m_iDomeRadius, kiSrcRadius);
+    }
+    //sources are hit where they are painted; update() leaves sources that did not move in their cells
+    bool bOutside;
+    for (int i = 0; i < ourProcessor->getNbrSources(); ++i){
+        m_oSourceHitGrid.update(i, getSourceMarkerOffset(i, bOutside));
+    }
+    for (int i = ourProcessor->getNbrSources(); i < ZirkOSC_Max_Sources; ++i){
+        m_oSourceHitGrid.remove(i);
+    }
+}
 
-        g.fillEllipse(_ZirkOSC_Center_X + fX-kiSrcRadius, _ZirkOSC_Center_Y + fY-kiSrcRadius, kiSrcDiameter, kiSrcDiameter);
+void ZirkOscAudioProcessorEditor::renderSourceSprites (int iSrc, float fHue, int iId){
+    m_aSourceAtlasHue[iSrc] = fHue;
+    m_aSourceAtlasId[iSrc]  = iId;
+    
+    const int iCell = m_oSourceAtlas.getWidth() / 2;
+    m_oSourceAtlas.clear(Rectangle<int>(0, iSrc * iCell, 2 * iCell, iCell));
+    Graphics g(m_oSourceAtlas);
+    g.addTransform(AffineTransform::scale(static_cast<float>(iCell) / kiSrcSpriteSize));
+    const String sId(iId);
+    const float fMargin = (kiSrcSpriteSize - kiSrcDiameter) / 2;
+    
+    for (int iState = 0; iState < 2; ++iState){
+        const float fLeft = iState * kiSrcSpriteSize + fMargin;
+        const float fTop  = iSrc   * kiSrcSpriteSize + fMargin;
+        
+        //---- draw source point
+        //fill source point
+        g.setColour(iState == 0 ? Colour::fromHSV(fHue, 1, 1, 1) : Colours::grey);
+        g.fillEllipse(fLeft, fTop, kiSrcDiameter, kiSrcDiameter);
         //draw outside of source point
         g.setColour(Colours::red);
-        g.drawEllipse(_ZirkOSC_Center_X + fX-kiSrcRadius, _ZirkOSC_Center_Y + fY-kiSrcRadius, kiSrcDiameter, kiSrcDiameter, 1);
+        g.drawEllipse(fLeft, fTop, kiSrcDiameter, kiSrcDiameter, 1);
         
         //---- draw source label
         //draw it in black
         g.setColour(Colours::black);
-        g.drawText(String(ourProcessor->getSources()[i].getSourceId()), _ZirkOSC_Center_X + fX-kiSrcRadius+1, _ZirkOSC_Center_Y + fY-kiSrcRadius+1, kiSrcDiameter, kiSrcDiameter, Justification(Justification::centred), false);
+        g.drawText(sId, fLeft+1, fTop+1, kiSrcDiameter, kiSrcDiameter, Justification(Justification::centred), false);
         
         //then in white, to create 3d effect
         g.setColour(Colours::white);
-        g.drawText(String(ourProcessor->getSources()[i].getSourceId()), _ZirkOSC_Center_X + fX-kiSrcRadius, _ZirkOSC_Center_Y + fY-kiSrcRadius, kiSrcDiameter, kiSrcDiameter, Justification(Justification::centred), false);
+        g.drawText(sId, fLeft, fTop, kiSrcDiameter, kiSrcDiameter, Justification(Justification::centred), false);
     }
 }
 
 void ZirkOscAudioProcessorEditor::paintWallCircle (Graphics& g){
     uint8 grey = 80;
     g.setColour(Colour(grey, grey, grey));
-    g.fillEllipse(_ZirkOSC_Center_X-ZirkOscAudioProcessor::s_iDomeRadius, _ZirkOSC_Center_Y-ZirkOscAudioProcessor::s_iDomeRadius, ZirkOscAudioProcessor::s_iDomeRadius * 2, ZirkOscAudioProcessor::s_iDomeRadius * 2);
+    g.fillEllipse(_ZirkOSC_Center_X-m_iDomeRadius, _ZirkOSC_Center_Y-m_iDomeRadius, m_iDomeRadius * 2, m_iDomeRadius * 2);
 }
 
 void ZirkOscAudioProcessorEditor::paintCenterDot (Graphics& g){
@@ -1022,27 +1387,30 @@ void ZirkOscAudioProcessorEditor::paintCenterDot (Graphics& g){
 
 void ZirkOscAudioProcessorEditor::paintCoordLabels (Graphics& g){
     g.setColour(Colours::white);
-    g.drawLine(_ZirkOSC_Center_X - ZirkOscAudioProcessor::s_iDomeRadius, _ZirkOSC_Center_Y, _ZirkOSC_Center_X + ZirkOscAudioProcessor::s_iDomeRadius, _ZirkOSC_Center_Y ,0.5f);
-    g.drawLine(_ZirkOSC_Center_X , _ZirkOSC_Center_Y - ZirkOscAudioProcessor::s_iDomeRadius, _ZirkOSC_Center_X , _ZirkOSC_Center_Y + ZirkOscAudioProcessor::s_iDomeRadius,0.5f);
+    g.drawLine(_ZirkOSC_Center_X - m_iDomeRadius, _ZirkOSC_Center_Y, _ZirkOSC_Center_X + m_iDomeRadius, _ZirkOSC_Center_Y ,0.5f);
+    g.drawLine(_ZirkOSC_Center_X , _ZirkOSC_Center_Y - m_iDomeRadius, _ZirkOSC_Center_X , _ZirkOSC_Center_Y + m_iDomeRadius,0.5f);
 }
 
 /*Conversion function*/
 
 /*!
-* \param p : Point <float> (Azimuth,Elevation) in degree, xy in range [-r, r]
+* \param p : Point <float> (Azimuth,Elevation) in degree, xy in range [-r, r] where r is the dome radius in pixels
 */
 Point <float> ZirkOscAudioProcessorEditor::degreeToXy (Point <float> p){
     float x,y;
-    x = -ZirkOscAudioProcessor::s_iDomeRadius * sinf(degreeToRadian(p.getX())) * cosf(degreeToRadian(p.getY()));
-    y = -ZirkOscAudioProcessor::s_iDomeRadius * cosf(degreeToRadian(p.getX())) * cosf(degreeToRadian(p.getY()));
+    x = -m_iDomeRadius * sinf(degreeToRadian(p.getX())) * cosf(degreeToRadian(p.getY()));
+    y = -m_iDomeRadius * cosf(degreeToRadian(p.getX())) * cosf(degreeToRadian(p.getY()));
     return Point <float> (x, y);
 }
 
+void ZirkOscAudioProcessorEditor::changeListenerCallback (ChangeBroadcaster*){
+    m_pFrameTicker->requestFrame(this);
+}
+
 /*!
- * Function called every 50ms to refresh value from Host
- * repaint only if the user is not moving any source (m_bIsSourceBeingDragged)
+ * Function called at most once per frame, after the processor asked for a refresh
  */
-void ZirkOscAudioProcessorEditor::timerCallback(){
+void ZirkOscAudioProcessorEditor::frameTick(){
     if (mTrState ==  kTrWriting){
         Trajectory::Ptr t = ourProcessor->getTrajectory();
         if (t) {
@@ -1057,36 +1425,42 @@ void ZirkOscAudioProcessorEditor::timerCallback(){
             mTrProgressBar->setVisible(false);
             m_pWriteTrajectoryButton->setToggleState(false, dontSendNotification);
             mTrState = kTrReady;
-            startEditorTimer(ZirkOSC_reg_timerDelay);
             clearTrajectoryPath();
         }
     }
+    if (m_oPositionTrail.update(ourProcessor->getPositionTrace(), Time::getMillisecondCounter())){
+        repaint();
+        //keep ticking while the trail fades out
+        m_pFrameTicker->requestFrame(this);
+    }
     if (ourProcessor->hasToRefreshGui()){
-//#if defined(TIMING_TESTS)
-//        clock_t begin = clock();
-//        clock_t proc = clock();
-//#endif
-        updateSliders();
-//#if defined(TIMING_TESTS)
-//        clock_t sliders = clock();
-//#endif
-        refreshGui();
-//#if defined(TIMING_TESTS)
-//        clock_t gui = clock();
-//#endif
+        {
+            ScopedPerformanceTimer oTimer(m_pPerformanceOverlay->getRefreshCounter(), m_pPerformanceOverlay->isVisible());
+            updateSliders();
+            refreshGui();
+            m_oSourceListTab->refresh(ourProcessor->takeChangedSources());
+        }
         repaint();
-//#if defined(TIMING_TESTS)
-//        clock_t end = clock();
-//        cout << "processor:\t" << proc - begin <<"ms"<< endl;
-//        cout << "sliders:\t" << sliders - proc <<"ms"<< endl;
-//        cout << "ref gui:\t" << gui - sliders <<"ms"<< endl;
-//        cout << "repaint:\t" << end - gui <<"ms"<< endl;
-//        cout << "whole thing:\t" << end - begin <<"ms"<< endl;
-//#endif
         ourProcessor->setRefreshGui(false);
     }
 }
 
+void ZirkOscAudioProcessorEditor::invalidateDisplayedValues(){
+    m_oShownOscPort.invalidate();
+    m_oShownNbrSources.invalidate();
+    m_oShownFirstSourceId.invalidate();
+    m_oShownConstraint.invalidate();
+    m_oShownOscActive.invalidate();
+    m_oShownSpanLinked.invalidate();
+    m_oShownTrajectoryType.invalidate();
+    m_oShownTrajectoryDirection.invalidate();
+    m_oShownTrajectoryReturn.invalidate();
+    m_oShownSyncWTempo.invalidate();
+    m_oShownTrajectoryCount.invalidate();
+    m_oShownTrajectoryDuration.invalidate();
+    m_oShownMorph.invalidate();
+}
+
 void ZirkOscAudioProcessorEditor::updateSliders(){
     int selectedSource = ourProcessor->getSelectedSource();
     //based on selected source, update all sliders
@@ -1102,27 +1476,62 @@ void ZirkOscAudioProcessorEditor::updateSliders(){
 }
 
 void ZirkOscAudioProcessorEditor::refreshGui(){
-    _ZkmOscPortTextEditor.setText(String(ourProcessor->getOscPortZirkonium()));
-    _NbrSourceTextEditor.setText(String(ourProcessor->getNbrSources()));
-    _FirstSourceIdTextEditor.setText(String(ourProcessor->getSources()[0].getSourceId()));
-    m_oMovementConstraintComboBox.setSelectedId(ourProcessor->getMovementConstraint());
-    _OscActiveButton.setToggleState(ourProcessor->getIsOscActive(), dontSendNotification);
-    _LinkSpanButton.setToggleState(ourProcessor->getIsSpanLinked(), dontSendNotification);
+    if (m_oShownOscPort.update(ourProcessor->getOscPortZirkonium())){
+        _ZkmOscPortTextEditor.setText(String(ourProcessor->getOscPortZirkonium()));
+    }
+    if (m_oShownNbrSources.update(ourProcessor->getNbrSources())){
+        _NbrSourceTextEditor.setText(String(ourProcessor->getNbrSources()));
+    }
+    if (m_oShownFirstSourceId.update(ourProcessor->getSources()[0].getSourceId())){
+        _FirstSourceIdTextEditor.setText(String(ourProcessor->getSources()[0].getSourceId()));
+    }
+    if (m_oShownConstraint.update(ourProcessor->getMovementConstraint())){
+        m_oMovementConstraintComboBox.setSelectedId(ourProcessor->getMovementConstraint());
+    }
+    if (m_oShownOscActive.update(ourProcessor->getIsOscActive())){
+        _OscActiveButton.setToggleState(ourProcessor->getIsOscActive(), dontSendNotification);
+    }
+    if (m_oShownSpanLinked.update(ourProcessor->getIsSpanLinked())){
+        _LinkSpanButton.setToggleState(ourProcessor->getIsSpanLinked(), dontSendNotification);
+    }
 
-    m_pTrajectoryTypeComboBox->setSelectedId(ourProcessor->getSelectedTrajectory());
+    if (m_oShownTrajectoryType.update(ourProcessor->getSelectedTrajectory())){
+        m_pTrajectoryTypeComboBox->setSelectedId(ourProcessor->getSelectedTrajectory());
+        //the direction and return combos are refilled for the new type
+        m_oShownTrajectoryDirection.invalidate();
+        m_oShownTrajectoryReturn.invalidate();
+    }
     
     int iCurTrajDirection = getNumSelectedTrajectoryDirections();
     if (iCurTrajDirection != -1){
-        m_pTrajectoryDirectionComboBox->setSelectedId(PercentToIntStartsAtOne(ourProcessor->getSelectedTrajectoryDirection(), iCurTrajDirection));
+        int iDirectionId = PercentToIntStartsAtOne(ourProcessor->getSelectedTrajectoryDirection(), iCurTrajDirection);
+        if (m_oShownTrajectoryDirection.update(iDirectionId)){
+            m_pTrajectoryDirectionComboBox->setSelectedId(iDirectionId);
+        }
     }
     int iCurTrajReturn = getNumSelectedTrajectoryReturns();
     if (iCurTrajReturn != -1){
-        m_pTrajectoryReturnComboBox->setSelectedId(PercentToIntStartsAtOne(ourProcessor->getSelectedTrajectoryReturn(), iCurTrajReturn));
+        int iReturnId = PercentToIntStartsAtOne(ourProcessor->getSelectedTrajectoryReturn(), iCurTrajReturn);
+        if (m_oShownTrajectoryReturn.update(iReturnId)){
+            m_pTrajectoryReturnComboBox->setSelectedId(iReturnId);
+        }
     }
     
-    ourProcessor->getIsSyncWTempo() ? m_pSyncWTempoComboBox->setSelectedId(SyncWTempo) : m_pSyncWTempoComboBox->setSelectedId(SyncWTime);
-    m_pTrajectoryCountTextEditor->setText(kFirstRowSpacing + String(ourProcessor->getParameter(ZirkOscAudioProcessor::ZirkOSCm_dTrajectoryCount_ParamId)));
-    m_pTrajectoryDurationTextEditor->setText(kFirstRowSpacing + String(ourProcessor->getParameter(ZirkOscAudioProcessor::ZirkOSC_TrajectoriesDuration_ParamId)));
+    if (m_oShownSyncWTempo.update(ourProcessor->getIsSyncWTempo())){
+        ourProcessor->getIsSyncWTempo() ? m_pSyncWTempoComboBox->setSelectedId(SyncWTempo) : m_pSyncWTempoComboBox->setSelectedId(SyncWTime);
+    }
+    float fCount = ourProcessor->getParameter(ZirkOscAudioProcessor::ZirkOSCm_dTrajectoryCount_ParamId);
+    if (m_oShownTrajectoryCount.update(fCount)){
+        m_pTrajectoryCountTextEditor->setText(kFirstRowSpacing + String(fCount));
+    }
+    float fDuration = ourProcessor->getParameter(ZirkOscAudioProcessor::ZirkOSC_TrajectoriesDuration_ParamId);
+    if (m_oShownTrajectoryDuration.update(fDuration)){
+        m_pTrajectoryDurationTextEditor->setText(kFirstRowSpacing + String(fDuration));
+    }
+    float fMorph = ourProcessor->getParameter(ZirkOscAudioProcessor::ZirkOSC_Morph_ParamId);
+    if (m_oShownMorph.update(fMorph)){
+        m_pMorphSlider->setValue(fMorph, dontSendNotification);
+    }
     
 //    _IpadIncomingOscPortTextEditor.setText(ourProcessor->getOscPortIpadIncoming());
 //    _IpadOutgoingOscPortTextEditor.setText(ourProcessor->getOscPortIpadOutgoing());
@@ -1130,11 +1539,13 @@ void ZirkOscAudioProcessorEditor::refreshGui(){
 }
 
 void ZirkOscAudioProcessorEditor::clearTrajectoryPath(){
-    m_fStartPathX = -1, m_fEndPathX = -1, m_fStartPathY = -1, m_fEndPathY = -1;
-    m_oTrajectoryPath.clear();
+    ourProcessor->getPositionTrace().discard();
+    m_oPositionTrail.clear();
 }
 
 void ZirkOscAudioProcessorEditor::buttonClicked (Button* button){
+    //the user may have left a widget showing something refreshGui does not know about
+    invalidateDisplayedValues();
     
     if(button == &_LinkSpanButton){
         ourProcessor->setIsSpanLinked(_LinkSpanButton.getToggleState());
@@ -1155,7 +1566,6 @@ void ZirkOscAudioProcessorEditor::buttonClicked (Button* button){
             m_pWriteTrajectoryButton->setToggleState(false, dontSendNotification);
 
             mTrState = kTrReady;
-            startEditorTimer(ZirkOSC_reg_timerDelay);
             clearTrajectoryPath();
             t->stop();  //this calls restoreCurrentLocations
             refreshGui();
@@ -1175,17 +1585,23 @@ void ZirkOscAudioProcessorEditor::buttonClicked (Button* button){
             float fTurns     = m_pTrajectoryTurnsTextEditor->getText().getFloatValue();
             float fDeviation = m_pTrajectoryDeviationTextEditor->getText().getFloatValue();
             float fDampening = m_pTrajectoryDampeningTextEditor->getText().getFloatValue();
+            float fSpeed     = ourProcessor->getRandomSpeed();
+            float fRoughness = ourProcessor->getRandomRoughness();
+            int   iSeed      = ourProcessor->getRandomSeed();
             
-            ourProcessor->setTrajectory(Trajectory::CreateTrajectory(type, ourProcessor, duration, beats, *direction, bReturn, repeats, source, ourProcessor->getEndLocationXY(), fTurns, fDeviation, fDampening));
+            ourProcessor->setTrajectory(Trajectory::CreateTrajectory(type, ourProcessor, duration, beats, *direction, bReturn, repeats, source, ourProcessor->getEndLocationXY(),
+                                                                     fTurns, fDeviation, fDampening, fSpeed, fRoughness, iSeed, ourProcessor->getDrawnSpline()));
             m_pWriteTrajectoryButton->setButtonText("Cancel");
             
             mTrState = kTrWriting;
-            startEditorTimer(ZirkOSC_traj_timerDelay);
             
             mTrProgressBar->setValue(0);
             mTrProgressBar->setVisible(true);
         }
     }
+    else if(button == m_pTBShowPerformance) {
+        m_pPerformanceOverlay->setVisible(m_pTBShowPerformance->getToggleState());
+    }
     else if(button == m_pTBEnableLeap) {
         if (m_pTBEnableLeap->getToggleState()) {
             if (!gIsLeapConnected) {
@@ -1249,6 +1665,34 @@ void ZirkOscAudioProcessorEditor::buttonClicked (Button* button){
             m_pLBJoystickState->setText("", dontSendNotification);
         }
     }
+    else if (button == m_pLibraryLoadButton){
+        loadTrajectoryFromLibrary();
+    }
+    else if (button == m_pSnapshotStoreButton){
+        String sName = m_pSnapshotComboBox->getText().trim();
+        if (sName.isNotEmpty() && !ourProcessor->storeSnapshot(sName)){
+            AlertWindow::showMessageBoxAsync (AlertWindow::WarningIcon, "ZirkOSC - Snapshots",
+                                              "There is no room left for another snapshot, delete one first.", "OK");
+        }
+        updateSnapshotComboBox();
+    }
+    else if (button == m_pSnapshotRecallButton){
+        ourProcessor->recallSnapshot(ourProcessor->getSnapshotIndex(m_pSnapshotComboBox->getText().trim()));
+    }
+    else if (button == m_pSnapshotDeleteButton){
+        ourProcessor->deleteSnapshot(ourProcessor->getSnapshotIndex(m_pSnapshotComboBox->getText().trim()));
+        m_pSnapshotComboBox->setText(String(), dontSendNotification);
+        updateSnapshotComboBox();
+    }
+    else if (button == m_pLibrarySaveButton){
+        saveTrajectoryToLibrary();
+    }
+    else if (button == m_pLibraryDeleteButton){
+        deleteTrajectoryFromLibrary();
+    }
+    else if (button == m_pDrawTrajectoryButton){
+        m_pDrawTrajectoryButton->setButtonText(m_pDrawTrajectoryButton->getToggleState() ? "Cancel" : "Draw");
+    }
     else if (button == m_pSetEndTrajectoryButton){
         if (m_pSetEndTrajectoryButton->getToggleState()){
             m_pSetEndTrajectoryButton->setButtonText("Cancel");
@@ -1286,6 +1730,9 @@ void ZirkOscAudioProcessorEditor::sliderDragStarted (Slider* slider) {
     if (slider == m_pGainSlider) {
         ourProcessor->beginParameterChangeGesture(ZirkOscAudioProcessor::ZirkOSC_Gain_ParamId + (selectedSource*5) );
     }
+    else if (slider == m_pMorphSlider) {
+        ourProcessor->beginParameterChangeGesture(ZirkOscAudioProcessor::ZirkOSC_Morph_ParamId);
+    }
     else if (slider == m_pAzimuthSlider) {
         ourProcessor->setIsRecordingAutomation(true);
         ourProcessor->beginParameterChangeGesture(ZirkOscAudioProcessor::ZirkOSC_X_ParamId + (selectedSource*5));
@@ -1329,6 +1776,9 @@ void ZirkOscAudioProcessorEditor::sliderDragEnded (Slider* slider) {
     if (slider == m_pGainSlider) {
         ourProcessor->endParameterChangeGesture(ZirkOscAudioProcessor::ZirkOSC_Gain_ParamId + (selectedSource*5) );
     }
+    else if (slider == m_pMorphSlider) {
+        ourProcessor->endParameterChangeGesture(ZirkOscAudioProcessor::ZirkOSC_Morph_ParamId);
+    }
     else if (slider == m_pAzimuthSlider) {
         ourProcessor->endParameterChangeGesture(ZirkOscAudioProcessor::ZirkOSC_X_ParamId + (selectedSource*5));
         ourProcessor->endParameterChangeGesture(ZirkOscAudioProcessor::ZirkOSC_Y_ParamId + (selectedSource*5));
@@ -1378,6 +1828,9 @@ void ZirkOscAudioProcessorEditor::sliderValueChanged (Slider* slider) {
     if (slider == m_pGainSlider) {
         ourProcessor->setParameterNotifyingHost (ZirkOscAudioProcessor::ZirkOSC_Gain_ParamId + (selectedSource*5), (float) m_pGainSlider->getValue());
     
+    } else if (slider == m_pMorphSlider) {
+        ourProcessor->setParameterNotifyingHost (ZirkOscAudioProcessor::ZirkOSC_Morph_ParamId, (float) m_pMorphSlider->getValue());
+    
     } else if (slider == m_pAzimuthSlider || slider == m_pElevationSlider){
         //figure out where the slider should move the point
         float newAzim01 = HRToPercent(m_pAzimuthSlider->getValue(),   ZirkOSC_Azim_Min, ZirkOSC_Azim_Max);
@@ -1409,9 +1862,20 @@ void ZirkOscAudioProcessorEditor::mouseDown (const MouseEvent &event){
     if (ourProcessor->getIsWriteTrajectory()){
         return;
     }
+    //start recording a drawn trajectory
+    if (m_pDrawTrajectoryButton->getToggleState()){
+        float fX = event.x-_ZirkOSC_Center_X;
+        float fY = event.y-_ZirkOSC_Center_Y;
+        if (hypotf(fX, fY) <= m_iDomeRadius){
+            m_bIsDrawingTrajectory = true;
+            m_oRecordingSpline.clear();
+            m_oRecordingSpline.addPoint(fX / m_iDomeRadius, fY / m_iDomeRadius);
+        }
+        return;
+    }
     int source = -1;
     //if event is within the wall circle, select source that is clicked on (if any)
-    if (event.x>5 && event.x <20+ZirkOscAudioProcessor::s_iDomeRadius*2 && event.y>5 && event.y< 40+ZirkOscAudioProcessor::s_iDomeRadius*2) {
+    if (getDomeViewBounds().contains(event.getPosition())) {
         source = getSourceFromPosition(Point<float>(event.x-_ZirkOSC_Center_X, event.y-_ZirkOSC_Center_Y));
     }
     
@@ -1424,20 +1888,66 @@ void ZirkOscAudioProcessorEditor::mouseDown (const MouseEvent &event){
         ourProcessor->beginParameterChangeGesture(ZirkOscAudioProcessor::ZirkOSC_X_ParamId + source*5);
         ourProcessor->beginParameterChangeGesture(ZirkOscAudioProcessor::ZirkOSC_Y_ParamId + source*5);
     }
+    //dragging outside of the sources pans a zoomed dome
+    else if (m_fZoom > 1 && getDomeViewBounds().contains(event.getPosition())){
+        m_bIsPanning = true;
+        m_oPanStart = m_oPan - event.position;
+    }
     m_oMovementConstraintComboBox.grabKeyboardFocus();
 }
 
-int ZirkOscAudioProcessorEditor::getSourceFromPosition(Point<float> p ){
-    for (int i = 0; i < ourProcessor->getNbrSources(); ++i){
-        if (ourProcessor->getSources()[i].contains(p)){
-            return i;
-        }
+void ZirkOscAudioProcessorEditor::mouseWheelMove (const MouseEvent &event, const MouseWheelDetails &wheel){
+    if (!getDomeViewBounds().contains(event.getPosition())){
+        return;
     }
-    return -1;
+    const float fNewZoom = jlimit(1.f, kfMaxDomeZoom, m_fZoom * (1 + wheel.deltaY));
+    if (fNewZoom == m_fZoom){
+        return;
+    }
+    //keep the point of the dome under the mouse where it is
+    const Point<float> oCenter(_ZirkOSC_Center_X, _ZirkOSC_Center_Y);
+    const Point<float> oUnzoomedCenter = oCenter - m_oPan;
+    const Point<float> oDomePoint = (event.position - oCenter) / static_cast<float>(m_iDomeRadius);
+    const float fUnzoomedRadius = m_iDomeRadius / m_fZoom;
+    m_fZoom = fNewZoom;
+    m_oPan  = event.position - oDomePoint * (fUnzoomedRadius * m_fZoom) - oUnzoomedCenter;
+    updateDomeView();
+}
+
+void ZirkOscAudioProcessorEditor::mouseDoubleClick (const MouseEvent &event){
+    if (m_fZoom > 1 && getSourceFromPosition(Point<float>(event.x-_ZirkOSC_Center_X, event.y-_ZirkOSC_Center_Y)) == -1){
+        m_fZoom = 1;
+        m_oPan  = Point<float>();
+        updateDomeView();
+    }
+}
+
+//p is relative to the dome center, in pixels
+int ZirkOscAudioProcessorEditor::getSourceFromPosition(Point<float> p ){
+    //sources may have moved since the last paint, or there may not have been one yet
+    updateSourceHitGrid();
+    return m_oSourceHitGrid.findSource(p);
 }
 
 
 void ZirkOscAudioProcessorEditor::mouseDrag (const MouseEvent &event){
+    if (m_bIsPanning){
+        m_oPan = m_oPanStart + event.position;
+        updateDomeView();
+        return;
+    }
+    if (m_bIsDrawingTrajectory){
+        float fX = event.x-_ZirkOSC_Center_X;
+        float fY = event.y-_ZirkOSC_Center_Y;
+        float fCurR = hypotf(fX, fY);
+        if (fCurR > m_iDomeRadius){
+            fX *= m_iDomeRadius / fCurR;
+            fY *= m_iDomeRadius / fCurR;
+        }
+        m_oRecordingSpline.addPoint(fX / m_iDomeRadius, fY / m_iDomeRadius);
+        repaint();
+        return;
+    }
     if(m_bIsSourceBeingDragged){
         if (ourProcessor->getIsWriteTrajectory()){
             return;
@@ -1447,23 +1957,12 @@ void ZirkOscAudioProcessorEditor::mouseDrag (const MouseEvent &event){
         float fY = event.y-_ZirkOSC_Center_Y;
         //need to clamp the point to the circle
             float fCurR = hypotf(fX, fY);
-            if ( fCurR > ZirkOscAudioProcessor::s_iDomeRadius){
-                float fExtraRatio = ZirkOscAudioProcessor::s_iDomeRadius / fCurR;
+            if ( fCurR > m_iDomeRadius){
+                float fExtraRatio = m_iDomeRadius / fCurR;
                 fX *= fExtraRatio;
                 fY *= fExtraRatio;
             }
-        move(ourProcessor->getSelectedSource(), fX, fY);
-//        //draw drag path
-//        if (m_fEndPathX == -1){
-//            m_fStartPathX = event.x;
-//            m_fStartPathY = event.y;
-//        } else {
-//            m_fStartPathX = m_fEndPathX;
-//            m_fStartPathY = m_fEndPathY;
-//        }
-//        m_fEndPathX = event.x;
-//        m_fEndPathY = event.y;
-//        repaint();
+        move(ourProcessor->getSelectedSource(), fX / m_iDomeRadius, fY / m_iDomeRadius);
     }
     //grab focus
     m_oMovementConstraintComboBox.grabKeyboardFocus();
@@ -1473,28 +1972,22 @@ void ZirkOscAudioProcessorEditor::move(int p_iSource, float p_fX, float p_fY, fl
     ourProcessor->move(p_iSource, p_fX, p_fY, p_fAzim01, p_fElev01);
 }
 
-void ZirkOscAudioProcessorEditor::updatePositionTrace(float p_fX, float p_fY){
-    float fAbsoluteX = p_fX + _ZirkOSC_Center_X;
-    float fAbsoluteY = p_fY + _ZirkOSC_Center_Y;
-    //draw drag path
-    if (m_fEndPathX == -1){
-        m_bPathJustStarted = true;
-        m_fStartPathX = fAbsoluteX;
-        m_fStartPathY = fAbsoluteY;
-    } else {
-        m_fStartPathX = m_fEndPathX;
-        m_fStartPathY = m_fEndPathY;
-    }
-    m_fEndPathX = fAbsoluteX;
-    m_fEndPathY = fAbsoluteY;
-    //repaint();
-}
-
 void ZirkOscAudioProcessorEditor::mouseUp (const MouseEvent &event){
-    
+    //a click on a zoomed dome starts a pan, but only a drag actually moves it
+    const bool bPanned = m_bIsPanning && !event.mouseWasClicked();
+    m_bIsPanning = false;
     if (ourProcessor->getIsWriteTrajectory()){
         return;
     }
+    else if (m_bIsDrawingTrajectory){
+        m_bIsDrawingTrajectory = false;
+        m_oRecordingSpline.build();
+        if (!m_oRecordingSpline.isEmpty()){
+            ourProcessor->setDrawnSpline(m_oRecordingSpline);
+        }
+        m_pDrawTrajectoryButton->setToggleState(false, dontSendNotification);
+        m_pDrawTrajectoryButton->setButtonText("Draw");
+    }
     else if(m_bIsSourceBeingDragged){
         int selectedSource = ourProcessor->getSelectedSource();
         ourProcessor->endParameterChangeGesture(ZirkOscAudioProcessor::ZirkOSC_X_ParamId+ selectedSource*5);
@@ -1504,11 +1997,11 @@ void ZirkOscAudioProcessorEditor::mouseUp (const MouseEvent &event){
     }
     
     //if assigning end location
-    else if (m_pSetEndTrajectoryButton->getToggleState() &&  event.x>5 && event.x <20+ZirkOscAudioProcessor::s_iDomeRadius*2 && event.y>5 && event.y< 40+ZirkOscAudioProcessor::s_iDomeRadius*2) {
+    else if (m_pSetEndTrajectoryButton->getToggleState() && !bPanned && getDomeViewBounds().contains(event.getPosition())) {
         //get point of current event
         float fCenteredX = event.x-_ZirkOSC_Center_X;
         float fCenteredY = event.y-_ZirkOSC_Center_Y;
-        ourProcessor->setEndLocationXY(make_pair (fCenteredX, fCenteredY));
+        ourProcessor->setEndLocationXY(make_pair (fCenteredX / m_iDomeRadius, fCenteredY / m_iDomeRadius));
         updateEndLocationTextEditors();
         m_pSetEndTrajectoryButton->setToggleState(false, dontSendNotification);
         m_pSetEndTrajectoryButton->setButtonText("Set end point");
@@ -1544,6 +2037,7 @@ void ZirkOscAudioProcessorEditor::textEditorFocusLost (TextEditor &textEditor){
 
 
 void ZirkOscAudioProcessorEditor::textEditorReturnKeyPressed (TextEditor &textEditor){
+    invalidateDisplayedValues();
     
     String text = textEditor.getText();
     int intValue = textEditor.getText().getIntValue();
@@ -1569,14 +2063,10 @@ void ZirkOscAudioProcessorEditor::textEditorReturnKeyPressed (TextEditor &textEd
             for (int iCurSource = 1; iCurSource < 8; ++iCurSource){
                 ourProcessor->getSources()[iCurSource].setSourceId(++sourceId);
             }
+            ourProcessor->askForAllSourcesRefresh();
             
             //toggle fixed angle repositioning, if we need to
-            int selectedConstraint = ourProcessor->getMovementConstraint();
-            if(selectedConstraint == EqualAzim){
-                ourProcessor->setEqualAzimForAllSrc();
-            } else if (selectedConstraint == EqualAzimElev){
-                ourProcessor->setEqualAzimElevForAllSrc();
-            }
+            ourProcessor->enforceMovementConstraint();
             
             updateConstraintCombo();
         }
@@ -1610,6 +2100,7 @@ void ZirkOscAudioProcessorEditor::textEditorReturnKeyPressed (TextEditor &textEd
         for (int iCurSource = 0; iCurSource < 8; ++iCurSource){
             ourProcessor->getSources()[iCurSource].setSourceId(newChannel++);
         }
+        ourProcessor->askForAllSourcesRefresh();
     }
     
     else if(&_ZkmOscPortTextEditor == &textEditor ){
@@ -1647,6 +2138,21 @@ void ZirkOscAudioProcessorEditor::textEditorReturnKeyPressed (TextEditor &textEd
             ourProcessor->setDampening(doubleValue);
         }
         m_pTrajectoryDampeningTextEditor->setText(String(ourProcessor->getDampening()));
+    } else if (m_pTrajectorySeedTextEditor == &textEditor){
+        ourProcessor->setRandomSeed(textEditor.getText().getIntValue());
+        m_pTrajectorySeedTextEditor->setText(String(ourProcessor->getRandomSeed()));
+    } else if (m_pTrajectoryRandomSpeedTextEditor == &textEditor){
+        double doubleValue = textEditor.getText().getDoubleValue();
+        if (doubleValue >= 0 && doubleValue <= 100){
+            ourProcessor->setRandomSpeed(doubleValue);
+        }
+        m_pTrajectoryRandomSpeedTextEditor->setText(String(ourProcessor->getRandomSpeed()));
+    } else if (m_pTrajectoryRoughnessTextEditor == &textEditor){
+        double doubleValue = textEditor.getText().getDoubleValue();
+        if (doubleValue >= 0 && doubleValue <= 1){
+            ourProcessor->setRandomRoughness(doubleValue);
+        }
+        m_pTrajectoryRoughnessTextEditor->setText(String(ourProcessor->getRandomRoughness()));
     }
 //    else if (&_IpadOutgoingOscPortTextEditor == &textEditor) { }
 //    else if (&_IpadIpAddressTextEditor == &textEditor) { }
@@ -1656,6 +2162,128 @@ void ZirkOscAudioProcessorEditor::textEditorReturnKeyPressed (TextEditor &textEd
     }
 }
 
+void ZirkOscAudioProcessorEditor::updateLibraryComboBox(){
+    String sCurrent = m_pLibraryComboBox->getText();
+    m_pLibraryComboBox->clear(dontSendNotification);
+    for (int iEntry = 0; iEntry < m_oTrajectoryLibrary.size(); ++iEntry){
+        m_pLibraryComboBox->addItem(m_oTrajectoryLibrary.getEntry(iEntry).m_sName, iEntry+1);
+    }
+    m_pLibraryComboBox->setText(sCurrent, dontSendNotification);
+}
+
+void ZirkOscAudioProcessorEditor::saveTrajectoryToLibrary(){
+    String sName = m_pLibraryComboBox->getText().trim();
+    if (sName.isEmpty()){
+        return;
+    }
+    TrajectoryLibraryEntry oEntry;
+    oEntry.m_sName          = sName;
+    oEntry.m_iType          = ourProcessor->getSelectedTrajectory();
+    oEntry.m_fDirection01   = ourProcessor->getSelectedTrajectoryDirection();
+    oEntry.m_fReturn01      = ourProcessor->getSelectedTrajectoryReturn();
+    oEntry.m_fDuration      = ourProcessor->getParameter(ZirkOscAudioProcessor::ZirkOSC_TrajectoriesDuration_ParamId);
+    oEntry.m_fCount         = ourProcessor->getParameter(ZirkOscAudioProcessor::ZirkOSCm_dTrajectoryCount_ParamId);
+    oEntry.m_bSyncWTempo    = ourProcessor->getIsSyncWTempo();
+    oEntry.m_fTurns         = ourProcessor->getTurns();
+    oEntry.m_fDeviation     = ourProcessor->getDeviation();
+    oEntry.m_fDampening     = ourProcessor->getDampening();
+    oEntry.m_fRandomSpeed   = ourProcessor->getRandomSpeed();
+    oEntry.m_fRoughness     = ourProcessor->getRandomRoughness();
+    oEntry.m_iSeed          = ourProcessor->getRandomSeed();
+    oEntry.m_fEndX          = ourProcessor->getEndLocationXY().first;
+    oEntry.m_fEndY          = ourProcessor->getEndLocationXY().second;
+    oEntry.m_oSpline        = ourProcessor->getDrawnSpline();
+    
+    //reload first so we don't overwrite what other instances saved in the meantime
+    if (!reloadTrajectoryLibraryForWriting()){
+        return;
+    }
+    m_oTrajectoryLibrary.set(oEntry);
+    if (!m_oTrajectoryLibrary.save(TrajectoryLibrary::getDefaultFile())){
+        AlertWindow::showMessageBoxAsync (AlertWindow::WarningIcon, "ZirkOSC - Trajectory library",
+                                          "Unable to write " + TrajectoryLibrary::getDefaultFile().getFullPathName(), "OK");
+    }
+    updateLibraryComboBox();
+}
+
+void ZirkOscAudioProcessorEditor::loadTrajectoryFromLibrary(){
+    m_oTrajectoryLibrary.load(TrajectoryLibrary::getDefaultFile());
+    updateLibraryComboBox();
+    int iEntry = m_oTrajectoryLibrary.indexOf(m_pLibraryComboBox->getText().trim());
+    if (iEntry == -1){
+        return;
+    }
+    const TrajectoryLibraryEntry &oEntry = m_oTrajectoryLibrary.getEntry(iEntry);
+    if (oEntry.m_iType < 1 || oEntry.m_iType >= TotalNumberTrajectories){
+        return;
+    }
+    ourProcessor->setParameterNotifyingHost(ZirkOscAudioProcessor::ZirkOSC_SelectedTrajectory_ParamId, IntToPercentStartsAtOne(oEntry.m_iType, TotalNumberTrajectories));
+    ourProcessor->setParameterNotifyingHost(ZirkOscAudioProcessor::ZirkOSC_SelectedTrajectoryDirection_ParamId, oEntry.m_fDirection01);
+    ourProcessor->setParameterNotifyingHost(ZirkOscAudioProcessor::ZirkOSC_SelectedTrajectoryReturn_ParamId, oEntry.m_fReturn01);
+    ourProcessor->setParameter(ZirkOscAudioProcessor::ZirkOSC_TrajectoriesDuration_ParamId, oEntry.m_fDuration);
+    ourProcessor->setParameter(ZirkOscAudioProcessor::ZirkOSCm_dTrajectoryCount_ParamId, oEntry.m_fCount);
+    ourProcessor->setIsSyncWTempo(oEntry.m_bSyncWTempo);
+    ourProcessor->setTurns(oEntry.m_fTurns);
+    ourProcessor->setDeviation(oEntry.m_fDeviation);
+    ourProcessor->setDampening(oEntry.m_fDampening);
+    ourProcessor->setRandomSpeed(oEntry.m_fRandomSpeed);
+    ourProcessor->setRandomRoughness(oEntry.m_fRoughness);
+    ourProcessor->setRandomSeed(oEntry.m_iSeed);
+    ourProcessor->setDrawnSpline(oEntry.m_oSpline);
+    ourProcessor->setEndLocationXY(make_pair(oEntry.m_fEndX, oEntry.m_fEndY));
+    
+    m_pTrajectoryTurnsTextEditor->setText(String(ourProcessor->getTurns()));
+    m_pTrajectoryDeviationTextEditor->setText(String(ourProcessor->getDeviation()));
+    m_pTrajectoryDampeningTextEditor->setText(String(ourProcessor->getDampening()));
+    m_pTrajectoryRandomSpeedTextEditor->setText(String(ourProcessor->getRandomSpeed()));
+    m_pTrajectoryRoughnessTextEditor->setText(String(ourProcessor->getRandomRoughness()));
+    m_pTrajectorySeedTextEditor->setText(String(ourProcessor->getRandomSeed()));
+    m_pTrajectoryDurationTextEditor->setText(kFirstRowSpacing + String(ourProcessor->getParameter(ZirkOscAudioProcessor::ZirkOSC_TrajectoriesDuration_ParamId)));
+    updateEndLocationTextEditors();
+    refreshGui();
+    updateTrajectoryComponents();
+    updateTurnsWidgetLocation();
+    repaint();
+}
+
+void ZirkOscAudioProcessorEditor::deleteTrajectoryFromLibrary(){
+    if (!reloadTrajectoryLibraryForWriting()){
+        return;
+    }
+    int iEntry = m_oTrajectoryLibrary.indexOf(m_pLibraryComboBox->getText().trim());
+    if (iEntry != -1){
+        m_oTrajectoryLibrary.remove(iEntry);
+        if (m_oTrajectoryLibrary.save(TrajectoryLibrary::getDefaultFile())){
+            m_pLibraryComboBox->setText(String(), dontSendNotification);
+        } else {
+            AlertWindow::showMessageBoxAsync (AlertWindow::WarningIcon, "ZirkOSC - Trajectory library",
+                                              "Unable to write " + TrajectoryLibrary::getDefaultFile().getFullPathName(), "OK");
+            m_oTrajectoryLibrary.load(TrajectoryLibrary::getDefaultFile());
+        }
+    }
+    updateLibraryComboBox();
+}
+
+bool ZirkOscAudioProcessorEditor::reloadTrajectoryLibraryForWriting(){
+    const File oFile = TrajectoryLibrary::getDefaultFile();
+    if (m_oTrajectoryLibrary.load(oFile) == TrajectoryLibrary::kLibraryUnreadable){
+        AlertWindow::showMessageBoxAsync (AlertWindow::WarningIcon, "ZirkOSC - Trajectory library",
+                                          oFile.getFullPathName() + " was written by a newer version of ZirkOSC or is damaged, so it was left untouched.", "OK");
+        updateLibraryComboBox();
+        return false;
+    }
+    return true;
+}
+
+void ZirkOscAudioProcessorEditor::updateSnapshotComboBox(){
+    String sCurrent = m_pSnapshotComboBox->getText();
+    m_pSnapshotComboBox->clear(dontSendNotification);
+    for (int iSnapshot = 0; iSnapshot < ourProcessor->getNbrSnapshots(); ++iSnapshot){
+        m_pSnapshotComboBox->addItem(ourProcessor->getSnapshotName(iSnapshot), iSnapshot+1);
+    }
+    m_pSnapshotComboBox->setText(sCurrent, dontSendNotification);
+}
+
 void ZirkOscAudioProcessorEditor::updateTurnsTextEditor(){
     double doubleValue = m_pTrajectoryTurnsTextEditor->getText().getDoubleValue();
     double dUpperLimit = 10.0;
@@ -1672,19 +2300,12 @@ void ZirkOscAudioProcessorEditor::updateTurnsTextEditor(){
 }
 
 void ZirkOscAudioProcessorEditor::comboBoxChanged (ComboBox* comboBoxThatHasChanged){
+    invalidateDisplayedValues();
     if (comboBoxThatHasChanged == &m_oMovementConstraintComboBox){
         int selectedConstraint = comboBoxThatHasChanged->getSelectedId();
         float fSelectedConstraint = IntToPercentStartsAtOne(selectedConstraint, TotalNumberConstraints);
         ourProcessor->setParameterNotifyingHost(ZirkOscAudioProcessor::ZirkOSC_MovementConstraint_ParamId, fSelectedConstraint);
-        if(selectedConstraint == EqualAzim){
-            ourProcessor->setEqualAzimForAllSrc();
-        } else if (selectedConstraint == EqualAzimElev){
-            ourProcessor->setEqualAzimElevForAllSrc();
-        } else if (selectedConstraint == EqualElev){
-            ourProcessor->setEqualElevForAllSrc();
-        } else if (selectedConstraint == SymmetricX || selectedConstraint == SymmetricY){
-            ourProcessor->setSymmetricForAllSrc();
-        }
+        ourProcessor->enforceMovementConstraint();
     } else if (comboBoxThatHasChanged == m_pTrajectoryTypeComboBox){
         int iSelectedTraj = comboBoxThatHasChanged->getSelectedId();
         float fSelectedTraj = IntToPercentStartsAtOne(iSelectedTraj, TotalNumberTrajectories);
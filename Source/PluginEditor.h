@@ -26,6 +26,11 @@
 
 #include "../JuceLibraryCode/JuceHeader.h"
 #include "PluginProcessor.h"
+#include "TrajectoryLibrary.h"
+#include "FrameTicker.h"
+#include "DisplayedValue.h"
+#include "SourceHitGrid.h"
+#include "SourceList.h"
 #include "Leap.h"
 #include "../../GrisCommonFiles/GrisLookAndFeel.h"
 
@@ -37,6 +42,7 @@ class MiniProgressBar;
 class SlidersTab;
 class TrajectoryTab;
 class InterfaceTab;
+class SnapshotsTab;
 class HIDDelegate;
 class ZirkLeap;
 class ZirkOscAudioProcessor;
@@ -44,7 +50,8 @@ class ZirkOscAudioProcessor;
 class ZirkOscAudioProcessorEditor  : public AudioProcessorEditor,
 public ButtonListener,
 public SliderListener,
-public Timer,
+public ChangeListener,
+public FrameTicker::Client,
 public TextEditorListener,
 public ComboBoxListener
 {
@@ -61,14 +68,24 @@ public:
     
     //! when you want to refresh the TextEditors.
     void refreshGui();
+    //! make the next refreshGui update every widget
+    void invalidateDisplayedValues();
     
     //! called when window is resized
     void resized() override;
     
+    //! the cached background uses the look and feel colours, so it is redrawn
+    void lookAndFeelChanged() override;
+    
     void updateWallCircleSize(int iCurWidth, int iCurHeight);
     void updateTrajectoryTabSize(int iCurw, int iCurHeight);
     void updateTurnsWidgetLocation();
+    //! x and y are in dome coordinates, [-1,1]
     void move (int, float, float, float p_fAzim01 = -1, float p_fElev01 = -1);
+    //! radius of the dome on screen, in pixels. Dome coordinates are only scaled by it for painting and hit testing
+    int getDomeRadius() const {
+        return m_iDomeRadius;
+    }
     
     //! Function to set the combination of Slider and Label.
     static void setSliderAndLabel(String labelText, Slider* slider, Label* label, float min, float max);
@@ -84,10 +101,15 @@ public:
     JUCE_COMPILER_WARNING("these 2 methods were created because of static issues in hid_delegate and such")
     int getNbSources();
     int getCBSelectedSource();
-    void startEditorTimer(int ms);
-    void updatePositionTrace(float p_fX, float p_fY);
     void updateConstraintCombo();
     void clearTrajectoryPath();
+    //! times each paint stage on its own, see Benchmarks/
+    friend class EditorBenchmark;
+    //! paint the background directly instead of through m_oBackgroundImage, to compare both
+    void setBackgroundCacheEnabled(bool p_bEnabled){
+        m_bBackgroundCacheEnabled = p_bEnabled;
+        m_oBackgroundImage = Image::null;
+    }
 private:
     
     ZirkOscAudioProcessor* ourProcessor;
@@ -97,6 +119,19 @@ private:
     void updateTurnsTextEditor();
     void setDefaultPendulumEndpoint();
     
+    //! fill the library combo box with the names in m_oTrajectoryLibrary
+    void updateLibraryComboBox();
+    //! reload the library before changing it; returns false, after telling the user, if the file is there but cannot be read
+    bool reloadTrajectoryLibraryForWriting();
+    //! store the current trajectory settings in the library under the name typed in the library combo box
+    void saveTrajectoryToLibrary();
+    //! apply the library entry selected in the library combo box to the current trajectory settings
+    void loadTrajectoryFromLibrary();
+    void deleteTrajectoryFromLibrary();
+    
+    //! fill the snapshot combo box with the processor's snapshot names
+    void updateSnapshotComboBox();
+    
     //! Called when a comboBox's value has changed
     void comboBoxChanged (ComboBox* comboBoxThatHasChanged) override;
     //! Called when a button is clicked
@@ -113,6 +148,15 @@ private:
  	void mouseDrag (const MouseEvent &event) override;
     //! Called when the mouse is up
  	void mouseUp (const MouseEvent &event) override;
+    //! zoom the dome view around the mouse
+    void mouseWheelMove (const MouseEvent &event, const MouseWheelDetails &wheel) override;
+    //! double-click outside of the sources to show the whole dome again
+    void mouseDoubleClick (const MouseEvent &event) override;
+    
+    //! area of the editor where the dome is shown, above the constraint combo box and tabs
+    Rectangle<int> getDomeViewBounds() const;
+    //! apply a new zoom or pan to the dome view
+    void updateDomeView();
     
     void setTrajectorySource();
 
@@ -120,7 +164,9 @@ private:
     void sliderDragStarted (Slider* slider) override;
     void sliderDragEnded (Slider* slider) override;
     
-    void timerCallback() override;
+    //! the processor changed something we show, ask for a frame
+    void changeListenerCallback (ChangeBroadcaster* source) override;
+    void frameTick() override;
     void textEditorReturnKeyPressed (TextEditor &editor) override;
     void textEditorFocusLost (TextEditor &editor) override;
     void setSliderAndLabelPosition(int x, int y, int width, int height, Slider* slider, Label* label);
@@ -151,11 +197,28 @@ private:
     TextEditor* m_pEndAzimTextEditor;
     TextEditor* m_pEndElevTextEditor;
     TextButton* m_pResetEndTrajectoryButton;
+    TextButton* m_pDrawTrajectoryButton;
+    
+    ComboBox*   m_pLibraryComboBox;
+    TextButton* m_pLibraryLoadButton;
+    TextButton* m_pLibrarySaveButton;
+    TextButton* m_pLibraryDeleteButton;
+    TrajectoryLibrary m_oTrajectoryLibrary;
+    
+    ComboBox*   m_pSnapshotComboBox;
+    TextButton* m_pSnapshotStoreButton;
+    TextButton* m_pSnapshotRecallButton;
+    TextButton* m_pSnapshotDeleteButton;
+    Slider*     m_pMorphSlider;
+    Label*      m_pMorphLabel;
     
     Label* m_pTrajectoryCountLabel;
     Label* m_pTrajectoryTurnsLabel;
     Label* m_pTrajectoryDeviationLabel;
     Label* m_pTrajectoryDampeningLabel;
+    Label* m_pTrajectorySeedLabel;
+    Label* m_pTrajectoryRandomSpeedLabel;
+    Label* m_pTrajectoryRoughnessLabel;
     Label* m_pTrajectoryDurationLabel;
     
     TextEditor* m_pTrajectoryCountTextEditor;
@@ -163,6 +226,9 @@ private:
     TextEditor* m_pTrajectoryDeviationTextEditor;
     TextEditor* m_pTrajectoryDurationTextEditor;
     TextEditor* m_pTrajectoryDampeningTextEditor;
+    TextEditor* m_pTrajectorySeedTextEditor;
+    TextEditor* m_pTrajectoryRandomSpeedTextEditor;
+    TextEditor* m_pTrajectoryRoughnessTextEditor;
     
   	MiniProgressBar *mTrProgressBar;
     
@@ -223,6 +289,9 @@ private:
     
     Label* m_pLBJoystickState;
     
+    //! Toggle Button to show the performance overlay
+    ToggleButton* m_pTBShowPerformance;
+    
     //joystick
     ReferenceCountedObjectPtr<HIDDelegate> mJoystick;
 
@@ -239,16 +308,66 @@ private:
     void paintCoordLabels (Graphics& g);
     //! Paint sources points
     void paintSourcePoint (Graphics& g);
+    //! Where the marker of source iSrc is drawn, relative to the dome center. Sources outside of the dome are drawn on its edge
+    Point<float> getSourceMarkerOffset (int iSrc, bool &bOutside);
+    //! Move the sources that moved to their new cells in m_oSourceHitGrid
+    void updateSourceHitGrid();
+    //! Render the markers of source iSrc into m_oSourceAtlas, in the normal and out-of-dome states
+    void renderSourceSprites (int iSrc, float fHue, int iId);
     //! Paint the span arc for iSrc
     void paintSpanArc (Graphics& g, int iSrc);
     //! Paint the wall circle, ie the main circle in the gui
     void paintWallCircle (Graphics& g);
+    //! Paint the gesture being drawn, or the stored drawn trajectory when it is selected
+    void paintDrawnTrajectory (Graphics& g);
+    //! Paint everything that only depends on the editor size and colours: the background, wall circle and coord labels
+    void paintBackground (Graphics& g);
+    //! Draw m_oBackgroundImage, rendering it first if it is missing or was made for another size or pixel scale
+    void drawCachedBackground (Graphics& g);
+    
+    //! span arc of one source, with what it was built from. paintSpanArc only rebuilds it when one of those changes
+    struct SpanArcGeometry {
+        float   m_fAzim01       = -1;
+        float   m_fElev01       = -1;
+        float   m_fAzimSpan01   = -1;
+        float   m_fElevSpan01   = -1;
+        int     m_iDomeRadius   = -1;
+        int     m_iCenterX      = -1;
+        int     m_iCenterY      = -1;
+        Path    m_oArea;
+        //! the stroke around m_oArea, already turned into a path to fill
+        Path    m_oOutline;
+    };
+    SpanArcGeometry m_aSpanArcs[ZirkOSC_Max_Sources];
+    
+    //! source markers with their id label, one row per source and one column per state (in the dome, outside of it).
+    //! Cleared on resize, and a row is rendered again when the hue or id of its source changes
+    Image m_oSourceAtlas;
+    float m_fSourceAtlasScale = 0;
+    float m_aSourceAtlasHue[ZirkOSC_Max_Sources];
+    int   m_aSourceAtlasId[ZirkOSC_Max_Sources];
+    
+    //! where the source markers are, for getSourceFromPosition
+    SourceHitGrid m_oSourceHitGrid;
+    
+    //! dome view zoom, [1, kfMaxDomeZoom], and offset of the dome center, in pixels. They only change how the dome is shown:
+    //! updateWallCircleSize folds them into _ZirkOSC_Center_X/Y and m_iDomeRadius, which every drawing and mouse function uses
+    float m_fZoom = 1;
+    Point<float> m_oPan;
+    bool m_bIsPanning = false;
+    Point<float> m_oPanStart;
+    
+    //! static layer of the dome, cleared on resize and look and feel changes
+    Image m_oBackgroundImage;
+    float m_fBackgroundScale = 0;
+    bool m_bBackgroundCacheEnabled = true;
     
     //! projects dome coords to screen coords (sphere to circle)
     Point <float> degreeToXy (Point <float>);
 
     int _ZirkOSC_Center_X;
     int _ZirkOSC_Center_Y;
+    int m_iDomeRadius = 172;
     
     SlidersTab* m_oSlidersTab;
     
@@ -256,6 +375,10 @@ private:
     
     InterfaceTab* m_oInterfaceTab;
     
+    SnapshotsTab* m_oSnapshotsTab;
+    
+    SourceListTab* m_oSourceListTab;
+    
     ScopedPointer<Leap::Controller> mLeapController;
     
     ReferenceCountedObjectPtr<ZirkLeap>  mleap;
@@ -269,14 +392,37 @@ private:
     float m_fHueOffset;
     Label m_oEndPointLabel;
     
-    Path m_oTrajectoryPath;
-    float m_fStartPathX, m_fStartPathY;
-    float m_fEndPathX,   m_fEndPathY;
-    bool m_bPathJustStarted;
+    //! trail behind the moving source, fed from the processor's position trace
+    PositionTrail m_oPositionTrail;
+    
+    //! paint, refresh, OSC and processor timings over the dome, hidden by default
+    ScopedPointer<PerformanceOverlay> m_pPerformanceOverlay;
+    
+    SharedResourcePointer<FrameTicker> m_pFrameTicker;
+    
+    //! values refreshGui last pushed to its widgets
+    DisplayedValue<int>   m_oShownOscPort;
+    DisplayedValue<int>   m_oShownNbrSources;
+    DisplayedValue<int>   m_oShownFirstSourceId;
+    DisplayedValue<int>   m_oShownConstraint;
+    DisplayedValue<bool>  m_oShownOscActive;
+    DisplayedValue<bool>  m_oShownSpanLinked;
+    DisplayedValue<int>   m_oShownTrajectoryType;
+    DisplayedValue<int>   m_oShownTrajectoryDirection;
+    DisplayedValue<int>   m_oShownTrajectoryReturn;
+    DisplayedValue<bool>  m_oShownSyncWTempo;
+    DisplayedValue<float> m_oShownTrajectoryCount;
+    DisplayedValue<float> m_oShownTrajectoryDuration;
+    DisplayedValue<float> m_oShownMorph;
+    
     LookAndFeel_V2 mV2Feel;
     LookAndFeel_V3 mV3Feel;
     GrisLookAndFeel mGrisFeel;
     int m_iTrCycleCount;
+    
+    //! gesture being recorded while the draw button is on
+    TrajectorySpline m_oRecordingSpline;
+    bool m_bIsDrawingTrajectory;
 
 };
 
@@ -79,7 +79,6 @@ private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SourceUpdateThread)
 };
 
-int ZirkOscAudioProcessor::s_iDomeRadius = 172;
 
 bool ZirkOscAudioProcessor::s_bForceConstraintAutomation = false;   //this was to force reaper to write an automation of the constraint combobox value when starting playback/record
 
@@ -96,6 +95,9 @@ ZirkOscAudioProcessor::ZirkOscAudioProcessor()
 ,m_dTrajectoryTurns(1.)
 ,m_dTrajectoryDeviation(0.)
 ,m_dTrajectoryDampening(0.)
+,m_dRandomSpeed(1.)
+,m_dRandomRoughness(.5)
+,m_iRandomSeed(1)
 //,_TrajectoriesPhiAsin(0)
 //,_TrajectoriesPhiAcos(0)
 ,m_bIsSyncWTempo(false)
@@ -177,14 +179,9 @@ void ZirkOscAudioProcessor::initSources(){
 }
 
 void ZirkOscAudioProcessor::updateSourcesSendOsc(){
+    ScopedPerformanceTimer oTimer(m_oPerformance.m_oTick, m_oPerformance.isEnabled());
     if (/*m_bCurrentlyPlaying && */!m_bIsRecordingAutomation && m_iMovementConstraint != Independent && m_iSourceLocationChanged != -1) {
-        if (m_iMovementConstraint == DeltaLocked){
-            moveDelta(m_iSourceLocationChanged, m_oAllSources[m_iSourceLocationChanged].getX(), m_oAllSources[m_iSourceLocationChanged].getY());
-        } else if (m_iMovementConstraint == SymmetricX || m_iMovementConstraint == SymmetricY){
-            moveSymmetric(m_iSourceLocationChanged, m_oAllSources[m_iSourceLocationChanged].getX(), m_oAllSources[m_iSourceLocationChanged].getY());
-        } else {
-            moveCircular(m_iSourceLocationChanged, m_oAllSources[m_iSourceLocationChanged].getX(), m_oAllSources[m_iSourceLocationChanged].getY());
-        }        
+        solveMovementConstraint(m_iSourceLocationChanged, false);
         m_iSourceLocationChanged = -1;
     }
     //OSC---------------------------
@@ -202,8 +199,8 @@ void ZirkOscAudioProcessor::move(const int &p_iSource, const float &p_fX, const
     float fX01, fY01;
     JUCE_COMPILER_WARNING("if we have an azim and an elev, we ignore (and overwrite) the provided x and y. That's because we can always retreive valid x,y for any azim,elev")
     if (p_fAzim01 == -1 && p_fElev01 == -1){
-        fX01 = HRToPercent(p_fX, -s_iDomeRadius, s_iDomeRadius);
-        fY01 = HRToPercent(p_fY, -s_iDomeRadius, s_iDomeRadius);
+        fX01 = HRToPercent(p_fX, -1, 1);
+        fY01 = HRToPercent(p_fY, -1, 1);
         setParameterNotifyingHost (ZirkOscAudioProcessor::ZirkOSC_X_ParamId + p_iSource*5, fX01);
         setParameterNotifyingHost (ZirkOscAudioProcessor::ZirkOSC_Y_ParamId + p_iSource*5, fY01);
 
@@ -215,296 +212,103 @@ void ZirkOscAudioProcessor::move(const int &p_iSource, const float &p_fX, const
         m_oAllSources[p_iSource].setAzimuth01(p_fAzim01);
         m_oAllSources[p_iSource].setElevation01(p_fElev01);
 
-        m_bNeedToRefreshGui = true;
+        askForSourceRefresh(p_iSource);
     }
     
     
-    //if non-independent, move non-selected sources
-    if(m_iMovementConstraint == Independent || getNbrSources() == 1){
-        m_oAllSources[p_iSource].setPrevLoc01(fX01, fY01, p_fAzim01, p_fElev01);
-    } else if (m_iMovementConstraint == DeltaLocked){
-        JUCE_COMPILER_WARNING("move with delta should use azim and elev")
-        moveDelta(p_iSource, p_fX, p_fY);
-    } else if (m_iMovementConstraint == SymmetricX || m_iMovementConstraint == SymmetricY){
-        JUCE_COMPILER_WARNING("this should also use azim and elev?")
-        moveSymmetric(p_iSource, p_fX, p_fY);
-    } else {
-        moveCircular(p_iSource, p_fX, p_fY, p_fAzim01, p_fElev01);
-    }
+    //move non-selected sources
+    solveMovementConstraint(p_iSource, false);
     
-    dynamic_cast<ZirkOscAudioProcessorEditor*>(m_oEditor)->updatePositionTrace(p_fX, p_fY);
-}
-
-void ZirkOscAudioProcessor::moveCircular(const int &p_iSelSource, const float &p_fSelectedNewX, const float &p_fSelectedNewY, const float &p_fAzim01, const float &p_fElev01){
-    //calculate delta azim+elev for selected source
-    float fSelectedDeltaAzim01, fSelectedDeltaElev01;
-    tie(fSelectedDeltaAzim01,fSelectedDeltaElev01) = getDeltasForSelectedSource(p_iSelSource, p_fSelectedNewX, p_fSelectedNewY, p_fAzim01, p_fElev01);
-    //return if no delta
-    if (abs(fSelectedDeltaAzim01) < .000001 && abs(fSelectedDeltaElev01) < .000001){
-//    if (fSelectedDeltaAzim01 == 0 && fSelectedDeltaElev01 == 0){
-        return;
+    //this can be the audio thread, so the editor is never called from here. It reads the trace on its own timer
+    m_oPositionTrace.push(p_fX, p_fY);
+}
+
+void ZirkOscAudioProcessor::askForSourceRefresh(int p_iSource){
+    m_oChangedSources.set(p_iSource);
+    askForGuiRefresh();
+}
+
+void ZirkOscAudioProcessor::askForAllSourcesRefresh(){
+    m_oChangedSources.setAll();
+    askForGuiRefresh();
+}
+
+void ZirkOscAudioProcessor::solveMovementConstraint(int p_iLeader, bool p_bEnforce){
+    const ScopedLock oLock(m_oConstraintLock);
+    SoundSource &oLeader = m_oAllSources[p_iLeader];
+    //the leader was just written, and all of its coordinates are read below and by the editor
+    oLeader.synchronize();
+    ConstraintContext oContext;
+    oContext.m_pSources         = m_oAllSources;
+    oContext.m_iNbrSources      = getNbrSources();
+    oContext.m_iLeader          = p_iLeader;
+    oContext.m_fLeaderX01       = oLeader.getX01();
+    oContext.m_fLeaderY01       = oLeader.getY01();
+    oContext.m_fLeaderAzim01    = oLeader.getAzimuth01();
+    oContext.m_fLeaderElev01    = oLeader.getElevation01();
+    oContext.m_bEnforce         = p_bEnforce;
+    oContext.m_pAzimuthOrder    = &m_oAzimuthOrder;
+    if (p_bEnforce){
+        oContext.m_fDeltaX01 = oContext.m_fDeltaY01 = oContext.m_fDeltaAzim01 = oContext.m_fDeltaElev01 = 0;
     } else {
-        float prevX01, prevY01;
-        m_oAllSources[p_iSelSource].getPrevXY01(prevX01, prevY01);
-        tie(fSelectedDeltaAzim01,fSelectedDeltaElev01) = getDeltasForSelectedSource(p_iSelSource, p_fSelectedNewX, p_fSelectedNewY, p_fAzim01, p_fElev01);
-    }
-    
-    
-    
-    
-    //move non-selected sources using the deltas
-    JUCE_COMPILER_WARNING("instead of applying the delta from the selected source linearly, we could probably do it with relation to the center, so that when going towards center, non-selected sources reach the middle at the same time as the selected source")
-    for (int iCurSource = 0; iCurSource < getNbrSources(); ++iCurSource) {
-        if (iCurSource == p_iSelSource){
-            //save new values as old values for next time
-            m_oAllSources[p_iSelSource].setPrevLoc01(HRToPercent(p_fSelectedNewX, -s_iDomeRadius, s_iDomeRadius), HRToPercent(p_fSelectedNewY, -s_iDomeRadius, s_iDomeRadius), p_fAzim01, p_fElev01);
-            continue;
-        }
-        //get current, non-selected source position
-        float fCurAzim01, fCurElev01;
-        tie(fCurAzim01, fCurElev01) = getCurrentSourcePosition(iCurSource);
-        //calculate new position
-        float fNewX01, fNewY01, fNewAzim01, fNewElev01;
-        tie(fNewX01, fNewY01, fNewAzim01, fNewElev01) = getNewSourcePosition(p_iSelSource, fSelectedDeltaAzim01, fSelectedDeltaElev01, iCurSource, fCurAzim01, fCurElev01);
-        //move source
-        m_oAllSources[iCurSource].setXYAzimElev01(fNewX01, fNewY01, fNewAzim01, fNewElev01);
-        JUCE_COMPILER_WARNING("there needs to be a way to do those 2 lines")
-//        m_oAllSources[iCurSource].setAzimuth01(p_fAzim01);
-//        m_oAllSources[iCurSource].setElevation01(p_fElev01);
-    }
-}
-
-pair<float, float> ZirkOscAudioProcessor::getDeltasForSelectedSource(const int &p_iSource, const float &p_fSelectedNewX, const float &p_fSelectedNewY, const float &p_fAzim01, const float &p_fElev01){
-    //get previous position
-    float fSelectedPrevAzim01 = m_oAllSources[p_iSource].getPrevAzim01();
-    float fSelectedPrevElev01 = m_oAllSources[p_iSource].getPrevElev01();
-    //get new position
-    float fSelectedNewAzim01, fSelectedNewElev01;
-    if (p_fAzim01 == -1 && p_fElev01 == -1){
-        fSelectedNewAzim01 = SoundSource::XYtoAzim01(p_fSelectedNewX, p_fSelectedNewY);
-        fSelectedNewElev01 = SoundSource::XYtoElev01(p_fSelectedNewX, p_fSelectedNewY);
-    } else {
-        fSelectedNewAzim01 = p_fAzim01;
-        fSelectedNewElev01 = p_fElev01;
-    }
-    //return the delta
-    return make_pair(fSelectedNewAzim01 - fSelectedPrevAzim01, fSelectedNewElev01 - fSelectedPrevElev01);
-}
-
-pair<float, float> ZirkOscAudioProcessor::getCurrentSourcePosition(int iCurSource){
-    float fCurAzim01, fCurElev01;
-    float fCurX = getParameter(ZirkOscAudioProcessor::ZirkOSC_X_ParamId + (iCurSource*5)) * 2 * s_iDomeRadius - s_iDomeRadius;
-    float fCurY = getParameter(ZirkOscAudioProcessor::ZirkOSC_Y_ParamId + (iCurSource*5)) * 2 * s_iDomeRadius - s_iDomeRadius;
-    
-    ElevationStatus elevationStatus = m_oAllSources[iCurSource].getElevationStatus();
-    if (elevationStatus == normalRange){
-        fCurElev01 = SoundSource::XYtoElev01(fCurX, fCurY);
-        fCurAzim01 = SoundSource::XYtoAzim01(fCurX, fCurY);
-    } else  {
-        float fCurElevOverflow = (m_oAllSources[iCurSource].getElevOverflow() - s_iDomeRadius) / s_iDomeRadius;
-        if (elevationStatus == over1){
-            fCurAzim01 = m_oAllSources[iCurSource].getPrevAzim01();
-            fCurElev01 = radianToDegree(acos(fCurElevOverflow));
-        } else if (elevationStatus == under0){
-            fCurAzim01 = SoundSource::XYtoAzim01(fCurX, fCurY);
-            fCurElev01 = radianToDegree(-asin(fCurElevOverflow));                       //need to convert output of asin which is is radians, to degree
-        } else {
-            jassert(0);
+        float fPrevX01, fPrevY01;
+        oLeader.getPrevXY01(fPrevX01, fPrevY01);
+        oContext.m_fDeltaX01    = oContext.m_fLeaderX01 - fPrevX01;
+        oContext.m_fDeltaY01    = oContext.m_fLeaderY01 - fPrevY01;
+        oContext.m_fDeltaAzim01 = oContext.m_fLeaderAzim01 - oLeader.getPrevAzim01();
+        oContext.m_fDeltaElev01 = oContext.m_fLeaderElev01 - oLeader.getPrevElev01();
+        //return if no delta
+        if (fabsf(oContext.m_fDeltaX01) < .000001 && fabsf(oContext.m_fDeltaY01) < .000001 && fabsf(oContext.m_fDeltaAzim01) < .000001 && fabsf(oContext.m_fDeltaElev01) < .000001){
+            return;
         }
-        fCurElev01 = HRToPercent(fCurElev01, ZirkOSC_Elev_Min, ZirkOSC_Elev_Max);   //then to percent
-    }
-    return make_pair(fCurAzim01, fCurElev01);
-}
-
-tuple<float, float, float, float> ZirkOscAudioProcessor::getNewSourcePosition(const int &p_iSelSource, const float &fSelectedDeltaAzim01, const float &fSelectedDeltaElev01, const int &iCurSource, const float &fCurAzim01, const float &fCurElev01){
-    float fNewX01, fNewY01, fCurElevOverflow;
-    //figure azim
-    float fNewAzim01 = checkAndFixAzim01Bounds(fCurAzim01 + fSelectedDeltaAzim01);
-
-    //figure elevation
-    float fNewElev01 = fCurElev01 + fSelectedDeltaElev01;
-    if (fNewElev01 >= 1 - std::numeric_limits<float>::epsilon()){
-        m_oAllSources[iCurSource].setElevationStatus(over1);
-        fCurElevOverflow = s_iDomeRadius + s_iDomeRadius * cos(degreeToRadian(PercentToHR(fNewElev01, ZirkOSC_Elev_Min, ZirkOSC_Elev_Max)));
-        fNewElev01 = 1;
-        SoundSource::azimElev01toXY01(fNewAzim01, fNewElev01, fNewX01, fNewY01, fCurElevOverflow);
-    }
-    else if (fNewElev01 < 0){                   //moving selected source moves this source out of the dome. need to calculate overflow
-        m_oAllSources[iCurSource].setElevationStatus(under0);
-        fCurElevOverflow = s_iDomeRadius - s_iDomeRadius * sin(degreeToRadian(PercentToHR(fNewElev01, ZirkOSC_Elev_Min, ZirkOSC_Elev_Max)));
-        fNewElev01 = 0;
-        SoundSource::azimElev01toXY01(fNewAzim01, fNewElev01, fNewX01, fNewY01, fCurElevOverflow);
-    }
-    else {  //normal range
-        m_oAllSources[iCurSource].setElevationStatus(normalRange);
-        SoundSource::azimElev01toXY01(fNewAzim01, fNewElev01, fNewX01, fNewY01);
-        fCurElevOverflow = s_iDomeRadius;
     }
+    //save new values as old values for next time
+    oLeader.setPrevLoc01(oContext.m_fLeaderX01, oContext.m_fLeaderY01, oContext.m_fLeaderAzim01, oContext.m_fLeaderElev01);
     
-    m_oAllSources[iCurSource].setElevOverflow(fCurElevOverflow);
-    m_oAllSources[iCurSource].setPrevLoc01(fNewX01, fNewY01, fNewAzim01, fNewElev01);
-    return make_tuple(fNewX01, fNewY01, fNewAzim01, fNewElev01);
-}
-
-void ZirkOscAudioProcessor::moveDelta(const int &p_iSource, const float &p_fX, const float &p_fY){
-    //calculate delta for selected source, which was already moved in ::move()
-    float fSelectedOldX01, fSelectedOldY01;
-    m_oAllSources[p_iSource].getPrevXY01(fSelectedOldX01, fSelectedOldY01);
-    float fSelectedDeltaX01 = HRToPercent(p_fX, -s_iDomeRadius, s_iDomeRadius) - fSelectedOldX01;
-    float fSelectedDeltaY01 = HRToPercent(p_fY, -s_iDomeRadius, s_iDomeRadius) - fSelectedOldY01;
-    
-    //move unselected sources to their current position + deltamove
-    for(int iCurSrc=0; iCurSrc<getNbrSources(); ++iCurSrc){
-        
-        if (iCurSrc == p_iSource){
-            //save old values for selected source
-            m_oAllSources[p_iSource].setPrevLoc01(HRToPercent(p_fX, -s_iDomeRadius, s_iDomeRadius), HRToPercent(p_fY, -s_iDomeRadius, s_iDomeRadius));
-            continue;
-        }
-        
-        float newX01 = getSources()[iCurSrc].getX01() + fSelectedDeltaX01;
-        float newY01 = getSources()[iCurSrc].getY01() + fSelectedDeltaY01;
-
-        m_oAllSources[iCurSrc].setXYAzimElev01(newX01, newY01);
-        m_oAllSources[iCurSrc].setPrevLoc01(newX01, newY01);
+    SourceGroup oGroup;
+    const bool bMovedOthers = solveConstraint(m_iMovementConstraint, oContext, oGroup);
+    if (bMovedOthers){
+        askForAllSourcesRefresh();
     }
-}
-//source here is the selected source, p_fX and p_fY is the position that it was already moved to, in ::move()
-void ZirkOscAudioProcessor::moveSymmetric(const int &p_iSource, const float &p_fX, const float &p_fY){
-
-    //selected source position in 01 range
-    float fSelectedX01 = HRToPercent(p_fX, -s_iDomeRadius, s_iDomeRadius);
-    float fSelectedY01 = HRToPercent(p_fY, -s_iDomeRadius, s_iDomeRadius);
-    
-    //move the other, unselected source
-    for(int iCurSrc = 0; iCurSrc<getNbrSources(); ++iCurSrc){
-        if (iCurSrc == p_iSource){
-            //save old values for selected source
-            m_oAllSources[p_iSource].setPrevLoc01(HRToPercent(p_fX, -s_iDomeRadius, s_iDomeRadius), HRToPercent(p_fY, -s_iDomeRadius, s_iDomeRadius));
-            continue;
+    if (bMovedOthers && p_bEnforce){
+        //the values are already set, so this only reaches the host
+        for (int iCurEntry = 0; iCurEntry < oGroup.size(); ++iCurEntry){
+            int iCurSrc = oGroup.getSource(iCurEntry);
+            setParameterNotifyingHost (ZirkOscAudioProcessor::ZirkOSC_X_ParamId + (iCurSrc*5), m_oAllSources[iCurSrc].getX01());
+            setParameterNotifyingHost (ZirkOscAudioProcessor::ZirkOSC_Y_ParamId + (iCurSrc*5), m_oAllSources[iCurSrc].getY01());
         }
-
-        float newX01 = fSelectedX01;
-        float newY01 = fSelectedY01;
-        
-        if (getMovementConstraint() == SymmetricX){
-            newY01 = 1-newY01;
-        } else {
-            newX01 = 1-newX01;
-        }
-        
-        m_oAllSources[iCurSrc].setXYAzimElev01(newX01, newY01);
-        m_oAllSources[iCurSrc].setPrevLoc01(newX01, newY01);
     }
 }
 
-int IndexedAngleCompare(const void *a, const void *b){
-    IndexedAngle *ia = (IndexedAngle*)a;
-    IndexedAngle *ib = (IndexedAngle*)b;
-    return (ia->a < ib->a) ? -1 : ((ia->a > ib->a) ? 1 : 0);
+bool ZirkOscAudioProcessor::storeSnapshot(const String &p_sName){
+    m_fAppliedMorph = m_fMorph.get();
+    return m_oSnapshots.capture(p_sName, m_oAllSources);
 }
 
-void ZirkOscAudioProcessor::setEqualAzimForAllSrc(){
-    
-    vector<int> fSortedAzims = getOrderSources();
-    
-    int   fSelPos   = fSortedAzims[m_iSelectedSource];
-    float fSelAzim  = m_oAllSources[m_iSelectedSource].getAzimuth01();
-    float fEqualDelta    = 1.f / m_iNbrSources;
-    
-    for(int iCurSrc = 0; iCurSrc < m_iNbrSources; ++iCurSrc){
-        if (iCurSrc == m_iSelectedSource){
-            continue;
-        }
-        
-        int iCurPos         = fSortedAzims[iCurSrc];
-        int iCurDistance    = iCurPos - fSelPos;
-        if (iCurDistance < 1) iCurDistance += m_iNbrSources;
-        float fCurDelta     = iCurDistance * fEqualDelta;
-        float fCurAngle     = fmodf(fSelAzim + fCurDelta, 1);
-        float fCurElev = m_oAllSources[iCurSrc].getElevation01();
-        setCurrentAndOldLocation(iCurSrc, fCurAngle, fCurElev);
+void ZirkOscAudioProcessor::recallSnapshot(int p_iSnapshot){
+    SourceGroup oGroup;
+    if (!m_oSnapshots.recall(p_iSnapshot, m_oAllSources, getNbrSources(), oGroup)){
+        return;
     }
-}
-
-void ZirkOscAudioProcessor::setEqualAzimElevForAllSrc(){
-    
-    vector<int> fSortedAzims = getOrderSources();
-    
-    int   fSelPos   = fSortedAzims[m_iSelectedSource];
-    float fSelAzim  = m_oAllSources[m_iSelectedSource].getAzimuth01();
-    float fSelElev  = m_oAllSources[m_iSelectedSource].getElevation01();
-    float fEqualDelta    = 1.f / m_iNbrSources;
-    
-    for(int iCurSrc = 0; iCurSrc < m_iNbrSources; ++iCurSrc){
-        if (iCurSrc == m_iSelectedSource){
-            continue;
-        }
-        
-        int iCurPos         = fSortedAzims[iCurSrc];
-        int iCurDistance    = iCurPos - fSelPos;
-        if (iCurDistance < 1) iCurDistance += m_iNbrSources;
-        float fCurDelta     = iCurDistance * fEqualDelta;
-        float fCurAngle     = fmodf(fSelAzim + fCurDelta, 1);
-        setCurrentAndOldLocation(iCurSrc, fCurAngle, fSelElev);
+    m_fAppliedMorph = m_fMorph.get();
+    //the values are already set, so this only reaches the host
+    for (int iCurSrc = 0; iCurSrc < getNbrSources(); ++iCurSrc){
+        setParameterNotifyingHost (ZirkOscAudioProcessor::ZirkOSC_X_ParamId        + (iCurSrc*5), m_oAllSources[iCurSrc].getX01());
+        setParameterNotifyingHost (ZirkOscAudioProcessor::ZirkOSC_Y_ParamId        + (iCurSrc*5), m_oAllSources[iCurSrc].getY01());
+        setParameterNotifyingHost (ZirkOscAudioProcessor::ZirkOSC_AzimSpan_ParamId + (iCurSrc*5), m_oAllSources[iCurSrc].getAzimuthSpan());
+        setParameterNotifyingHost (ZirkOscAudioProcessor::ZirkOSC_ElevSpan_ParamId + (iCurSrc*5), m_oAllSources[iCurSrc].getElevationSpan());
+        setParameterNotifyingHost (ZirkOscAudioProcessor::ZirkOSC_Gain_ParamId     + (iCurSrc*5), m_oAllSources[iCurSrc].getGain01());
     }
-
+    askForAllSourcesRefresh();
 }
 
-void ZirkOscAudioProcessor::setEqualElevForAllSrc(){
-    float fSelElevation01 = m_oAllSources[m_iSelectedSource].getElevation01();
-    for(int iCurSrc = 0; iCurSrc < getNbrSources() ; ++iCurSrc){
-        float fCurAzim01 = m_oAllSources[iCurSrc].getAzimuth01();
-        setCurrentAndOldLocation(iCurSrc, fCurAzim01, fSelElevation01);
-    }
+void ZirkOscAudioProcessor::deleteSnapshot(int p_iSnapshot){
+    m_fAppliedMorph = m_fMorph.get();
+    m_oSnapshots.remove(p_iSnapshot);
 }
 
-void ZirkOscAudioProcessor::setSymmetricForAllSrc(){
-    float fX01 = m_oAllSources[m_iSelectedSource].getX01();
-    float fY01 = m_oAllSources[m_iSelectedSource].getY01();
-    for(int iCurSrc = 0; iCurSrc < getNbrSources(); ++iCurSrc){
-        if (iCurSrc != m_iSelectedSource){
-            if (getMovementConstraint() == SymmetricX){
-                fY01 = 1-fY01;
-            } else {
-                fX01 = 1-fX01;
-            }
-            setParameterNotifyingHost (ZirkOscAudioProcessor::ZirkOSC_X_ParamId + (iCurSrc*5), fX01);
-            setParameterNotifyingHost (ZirkOscAudioProcessor::ZirkOSC_Y_ParamId + (iCurSrc*5), fY01);
-            m_oAllSources[iCurSrc].setPrevLoc01(fX01, fY01);
-        }
-    }
-}
-
-
-
-void ZirkOscAudioProcessor::setCurrentAndOldLocation(const int &p_iSrc, const float &p_fAzim01, const float &p_fElev01){
-    float fX01, fY01;
-    SoundSource::azimElev01toXY01(p_fAzim01, p_fElev01, fX01, fY01);
-    setParameterNotifyingHost (ZirkOscAudioProcessor::ZirkOSC_X_ParamId + (p_iSrc*5), fX01);
-    setParameterNotifyingHost (ZirkOscAudioProcessor::ZirkOSC_Y_ParamId + (p_iSrc*5), fY01);
-    m_oAllSources[p_iSrc].setPrevLoc01(fX01, fY01, p_fAzim01, p_fElev01);
-}
-
-
-
-
-vector<int> ZirkOscAudioProcessor::getOrderSources(){
-    //gather unsorted information
-    std::vector<IndexedAngle> indexedAngles (m_iNbrSources);
-    for (int iCurSrc = 0; iCurSrc < m_iNbrSources; iCurSrc++) {
-        indexedAngles[iCurSrc].i = iCurSrc;
-        indexedAngles[iCurSrc].a = m_oAllSources[iCurSrc].getAzimuth01();
-    }
-    //sort and return sorted angles
-    qsort(&indexedAngles[0], m_iNbrSources, sizeof(IndexedAngle), IndexedAngleCompare);
-    
-    std::vector<int> sourceOrder(m_iNbrSources);
-    for (int iCurPos = 0; iCurPos < m_iNbrSources; ++iCurPos) {
-        int iCurSrc = indexedAngles[iCurPos].i;
-        sourceOrder[iCurSrc] = iCurPos;
-    }
-    return sourceOrder;
+void ZirkOscAudioProcessor::enforceMovementConstraint(){
+    solveMovementConstraint(m_iSelectedSource, true);
 }
 
 
@@ -538,7 +342,7 @@ void ZirkOscAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBloc
     }
 }
 
-void ZirkOscAudioProcessor::processBlock (AudioSampleBuffer& buffer, MidiBuffer& midiMessages){
+void ZirkOscAudioProcessor::processBlock (AudioSampleBuffer&, MidiBuffer& midiMessages){
 
     AudioPlayHead::CurrentPositionInfo cpi;
     getPlayHead()->getCurrentPosition(cpi);
@@ -570,24 +374,21 @@ void ZirkOscAudioProcessor::processBlock (AudioSampleBuffer& buffer, MidiBuffer&
             // we're playing!
             mLastTimeInSamples = cpi.timeInSamples;
             
-            double bps = cpi.bpm / 60;
-            double sampleRate = getSampleRate();
-            unsigned int oriFramesToProcess = buffer.getNumSamples();
-            float seconds = oriFramesToProcess / sampleRate;
-            float beats = seconds * bps;
-            
-            bool done = trajectory->process(seconds, beats);
+            //trajectory time is derived from the host position itself, not accumulated block by block
+            bool done = trajectory->process(cpi, getSampleRate());
             if (done){
                 mTrajectory = NULL;
                 m_bIsWriteTrajectory = false;
+                askForGuiRefresh();
             }
         }
-    }
-}
-
-void ZirkOscAudioProcessor::updatePositions(){
-    for (int iCurSource = 0; iCurSource<8; ++iCurSource){
-        m_oAllSources[iCurSource].updatePosition();
+    } else {
+        //snapshot morph, once per block. It does not fight a trajectory being written
+        const float fMorph = m_fMorph.get();
+        if (fMorph != m_fAppliedMorph.get() && m_oSnapshots.morph(fMorph, m_oAllSources, getNbrSources(), m_oMorphGroup)){
+            m_fAppliedMorph = fMorph;
+            askForAllSourcesRefresh();
+        }
     }
 }
 
@@ -809,6 +610,8 @@ float ZirkOscAudioProcessor::getParameter (int index)
                 return 1.0f;
             else
                 return 0.0f;
+        case ZirkOSC_Morph_ParamId:
+            return m_fMorph.get();
     }
     
     for(int iCurSrc = 0; iCurSrc< 8; ++iCurSrc){
@@ -850,65 +653,65 @@ bool ZirkOscAudioProcessor::setOtherParameters(int index, float newValue){
         case ZirkOSC_MovementConstraint_ParamId:
             if (m_fMovementConstraint != newValue){
                 setMovementConstraint(newValue);
-                m_bNeedToRefreshGui = true;
+                askForGuiRefresh();
             }
             return true;
         case ZirkOSC_isOscActive_ParamId:
             if (newValue > .5f && !m_bIsOscActive){
                 m_bIsOscActive = true;
-                m_bNeedToRefreshGui = true;
+                askForGuiRefresh();
             } else if (m_bIsOscActive){
                 m_bIsOscActive = false;
-                m_bNeedToRefreshGui = true;
+                askForGuiRefresh();
             }
             return true;
         case ZirkOSC_isSpanLinked_ParamId:
             if (newValue > .5f && !m_bIsSpanLinked){
                 m_bIsSpanLinked = true;
-                m_bNeedToRefreshGui = true;
+                askForGuiRefresh();
             } else if (m_bIsSpanLinked){
                 m_bIsSpanLinked = false;
-                m_bNeedToRefreshGui = true;
+                askForGuiRefresh();
             }
             return true;
         case ZirkOSC_SelectedTrajectory_ParamId:
             if (m_fSelectedTrajectory != newValue){
                 m_fSelectedTrajectory = newValue;
-                m_bNeedToRefreshGui = true;
+                askForGuiRefresh();
             }
             return true;
         case ZirkOSC_SelectedTrajectoryDirection_ParamId:
             if(m_fSelectedTrajectoryDirection != newValue){
                 m_fSelectedTrajectoryDirection = newValue;
-                m_bNeedToRefreshGui = true;
+                askForGuiRefresh();
             }
             return true;
         case ZirkOSC_SelectedTrajectoryReturn_ParamId:
             if(m_fSelectedTrajectoryReturn != newValue){
                 m_fSelectedTrajectoryReturn = newValue;
-                m_bNeedToRefreshGui = true;
+                askForGuiRefresh();
             }
             return true;
         case ZirkOSCm_dTrajectoryCount_ParamId:
             JUCE_COMPILER_WARNING("is this ever used??")
             if(m_dTrajectoryCount != newValue){
                 m_dTrajectoryCount = newValue;
-                m_bNeedToRefreshGui = true;
+                askForGuiRefresh();
             }
             return true;
         case ZirkOSC_TrajectoriesDuration_ParamId:
             if(m_dTrajectoriesDuration != newValue){
                 m_dTrajectoriesDuration = newValue;
-                m_bNeedToRefreshGui = true;
+                askForGuiRefresh();
             }
             return true;
         case ZirkOSC_SyncWTempo_ParamId:
             if (newValue > .5f && !m_bIsSyncWTempo){
                 m_bIsSyncWTempo = true;
-                m_bNeedToRefreshGui = true;
+                askForGuiRefresh();
             } else if (m_bIsSyncWTempo){
                 m_bIsSyncWTempo = false;
-                m_bNeedToRefreshGui = true;
+                askForGuiRefresh();
             }
             return true;
         case ZirkOSC_WriteTrajectories_ParamId:
@@ -917,6 +720,10 @@ bool ZirkOscAudioProcessor::setOtherParameters(int index, float newValue){
             else
                 m_bIsWriteTrajectory = false;
             return true;
+        case ZirkOSC_Morph_ParamId:
+            //the sources are moved in processBlock
+            m_fMorph = newValue;
+            return true;
     }
     return false;
 }
@@ -927,7 +734,7 @@ bool ZirkOscAudioProcessor::setPositionParameters(int index, float newValue){
             if(newValue != m_oAllSources[iCurSource].getX01()) {
                 m_oAllSources[iCurSource].setX01(newValue);
                 m_iSourceLocationChanged = iCurSource;
-                m_bNeedToRefreshGui = true;
+                askForSourceRefresh(iCurSource);
             }
             return true;
         }
@@ -935,27 +742,27 @@ bool ZirkOscAudioProcessor::setPositionParameters(int index, float newValue){
             if(newValue != m_oAllSources[iCurSource].getY01()) {
                 m_oAllSources[iCurSource].setY01(newValue);
                 m_iSourceLocationChanged = iCurSource;
-                m_bNeedToRefreshGui = true;
+                askForSourceRefresh(iCurSource);
             }
             return true;
         } else if (ZirkOSC_AzimSpan_ParamId + (iCurSource*5) == index){
             if (newValue != m_oAllSources[iCurSource].getAzimuthSpan()){
             m_oAllSources[iCurSource].setAzimuthSpan(newValue);
-            m_bNeedToRefreshGui = true;
+            askForSourceRefresh(iCurSource);
             }
             return true;
         }
         else if (ZirkOSC_ElevSpan_ParamId + (iCurSource*5) == index){
             if (newValue != m_oAllSources[iCurSource].getElevationSpan()){
                 m_oAllSources[iCurSource].setElevationSpan(newValue);
-                m_bNeedToRefreshGui = true;
+                askForSourceRefresh(iCurSource);
             }
             return true;
         }
         else if (ZirkOSC_Gain_ParamId + (iCurSource*5) == index){
             if (newValue != m_oAllSources[iCurSource].getGain01()){
                 m_oAllSources[iCurSource].setGain01(newValue);
-                m_bNeedToRefreshGui = true;
+                askForSourceRefresh(iCurSource);
             }
             return true;
         }
@@ -995,6 +802,8 @@ const String ZirkOscAudioProcessor::getParameterName (int index) {
             return ZirkOSCm_bIsSyncWTempo_name;
         case ZirkOSC_WriteTrajectories_ParamId:
             return ZirkOSCm_bIsWriteTrajectory_name;
+        case ZirkOSC_Morph_ParamId:
+            return ZirkOSC_Morph_name;
     }
     for(int i = 0; i<8; ++i){
         if      (ZirkOSC_X_ParamId + (i*5) == index) {
@@ -1012,7 +821,7 @@ const String ZirkOscAudioProcessor::getParameterName (int index) {
     return String::empty;
 }
 
-static const int s_kiDataVersion = 4;
+static const int s_kiDataVersion = 5;
 
 //==============================================================================
 void ZirkOscAudioProcessor::getStateInformation (MemoryBlock& destData)
@@ -1039,6 +848,12 @@ void ZirkOscAudioProcessor::getStateInformation (MemoryBlock& destData)
     xml.setAttribute("turns", m_dTrajectoryTurns);
     xml.setAttribute("deviation", m_dTrajectoryDeviation);
     xml.setAttribute("dampening", m_dTrajectoryDampening);
+    xml.setAttribute("randomSpeed", m_dRandomSpeed);
+    xml.setAttribute("randomRoughness", m_dRandomRoughness);
+    xml.setAttribute("randomSeed", m_iRandomSeed);
+    xml.setAttribute("drawnTrajectory", m_oDrawnSpline.toString());
+    xml.setAttribute("morph", m_fMorph.get());
+    m_oSnapshots.toXml(*xml.createNewChildElement("Snapshots"));
     
     for(int iCurSrc = 0; iCurSrc < 8; ++iCurSrc){
         String channel      = "Channel"         + to_string(iCurSrc);
@@ -1096,11 +911,28 @@ void ZirkOscAudioProcessor::setStateInformation (const void* data, int sizeInByt
         m_dTrajectoriesDuration         = static_cast<float>(xmlState->getDoubleAttribute("durationTrajectory", .0f));
         m_bIsSyncWTempo                 = xmlState->getBoolAttribute("isSyncWTempo", false);
         m_bIsWriteTrajectory            = xmlState->getBoolAttribute("isWriteTrajectory", false);
-        m_fEndLocationXY.first          = xmlState->getDoubleAttribute("endLocationAzim", 180.0);
-        m_fEndLocationXY.second         = xmlState->getDoubleAttribute("endLocationElev", 90.0);
+        //despite their names, these attributes hold x and y in [-1,1]; without them the end location is the center of the dome
+        m_fEndLocationXY.first          = xmlState->getDoubleAttribute("endLocationAzim", 0.);
+        m_fEndLocationXY.second         = xmlState->getDoubleAttribute("endLocationElev", 0.);
+        if (version < 5){
+            //the end location used to be stored in editor pixels. The radius it was saved with is unknown, so assume the default one
+            const float fLegacyDomeRadius = 172;
+            m_fEndLocationXY.first  /= fLegacyDomeRadius;
+            m_fEndLocationXY.second /= fLegacyDomeRadius;
+        }
         m_dTrajectoryTurns              = xmlState->getDoubleAttribute("turns", m_dTrajectoryTurns);
         m_dTrajectoryDeviation          = xmlState->getDoubleAttribute("deviation", m_dTrajectoryDeviation);
         m_dTrajectoryDampening          = xmlState->getDoubleAttribute("dampening", m_dTrajectoryDampening);
+        m_dRandomSpeed                  = xmlState->getDoubleAttribute("randomSpeed", m_dRandomSpeed);
+        m_dRandomRoughness              = xmlState->getDoubleAttribute("randomRoughness", m_dRandomRoughness);
+        m_iRandomSeed                   = xmlState->getIntAttribute("randomSeed", m_iRandomSeed);
+        m_oDrawnSpline.fromString(xmlState->getStringAttribute("drawnTrajectory"));
+        //the stored locations below are where the sources were at this morph
+        m_fMorph                        = static_cast<float>(xmlState->getDoubleAttribute("morph", 0));
+        m_fAppliedMorph                 = m_fMorph.get();
+        if (XmlElement *pSnapshots = xmlState->getChildByName("Snapshots")){
+            m_oSnapshots.fromXml(*pSnapshots);
+        }
         
         for (int iCurSrc = 0; iCurSrc < 8; ++iCurSrc){
             String channel      = "Channel"         + to_string(iCurSrc);
@@ -1140,12 +972,13 @@ void ZirkOscAudioProcessor::setStateInformation (const void* data, int sizeInByt
         m_fSelectedTrajectoryDirection = static_cast<float>(xmlState->getDoubleAttribute("selectedTrajectoryDirection", .0f));
         m_fSelectedTrajectoryReturn    = static_cast<float>(xmlState->getDoubleAttribute("selectedTrajectoryReturn", .0f));
         connectOsc(m_iOscPortZirkonium);
-        m_bNeedToRefreshGui=true;
+        askForAllSourcesRefresh();
     }
 }
 
 //OSC-------------------------
 void ZirkOscAudioProcessor::sendOSCValues(){
+    const bool bCount = m_oPerformance.isEnabled();
     for(int iCurSrc = 0; iCurSrc <m_iNbrSources; ++iCurSrc){
         int   channel_osc   = m_oAllSources[iCurSrc].getSourceId()-1;
         float azim_osc      = PercentToHR(m_oAllSources[iCurSrc].getAzimuth01(), -1, 1);        //-1 is in the back right and +1 in the back left. 0 is forward
@@ -1167,6 +1000,11 @@ void ZirkOscAudioProcessor::sendOSCValues(){
         
         if (!mOscSender.send(message)) {
             DBG("Error: could not send OSC message.");
+            if (bCount){
+                m_oPerformance.m_oOscErrors.add();
+            }
+        } else if (bCount){
+            m_oPerformance.m_oOscSent.add();
         }
     }
     //OSC-------------------------
@@ -28,18 +28,15 @@
 
 //#include "ZirkConstants.h"
 #include "SoundSource.h"
+#include "Constraints.h"
+#include "SourceSnapshots.h"
+#include "PositionTrace.h"
+#include "PerformanceStats.h"
+#include "SourceSet.h"
 #include "Trajectories.h"
 
 class SourceUpdateThread;
 
-typedef struct
-{
-    int i;
-    float a;
-} IndexedAngle;
-
-int IndexedAngleCompare(const void *a, const void *b);
-
 /**
  The processor class of the plug in
  */
@@ -139,7 +136,7 @@ public:
                 setSelectedSource(0);
             }
             m_iNbrSources = newValue;
-            m_bNeedToRefreshGui = true;
+            askForAllSourcesRefresh();
         }
     }
     
@@ -173,14 +170,8 @@ public:
     void setSelectedSource(int selected){
         if ( selected >-1 && selected < 8){
             m_iSelectedSource = selected;
-            if(m_iMovementConstraint == EqualAzim){
-                setEqualAzimForAllSrc();
-            } else if (m_iMovementConstraint == EqualAzimElev){
-                setEqualAzimElevForAllSrc();
-            } else if (m_iMovementConstraint == EqualElev){
-                setEqualElevForAllSrc();
-            }
-            m_bNeedToRefreshGui = true;
+            enforceMovementConstraint();
+            askForGuiRefresh();
         }
     }
     //! Returns the Osc Port for the Zirkonium sending
@@ -238,7 +229,8 @@ public:
         ZirkOSC_TrajectoriesDuration_ParamId,
         ZirkOSC_SyncWTempo_ParamId,
         ZirkOSC_WriteTrajectories_ParamId,
-        totalNumParams                      //50
+        ZirkOSC_Morph_ParamId,              //50
+        totalNumParams
     };
     
     //! Send the current state to all the iPad and Zirkonium
@@ -260,6 +252,9 @@ public:
     
     //! Retunrs true if the Editor has to refresh the Gui.
     bool hasToRefreshGui(){return m_bNeedToRefreshGui;};
+    //! Editors listen to this to know when to refresh. It is safe to call sendChangeMessage from the audio thread,
+    //! and many changes before the editor gets the message only give one callback
+    ChangeBroadcaster& getGuiRefreshBroadcaster(){return m_oGuiRefreshBroadcaster;};
     //! If you want to refresh the Gui from the Processor.
     void setRefreshGui(bool gui) { m_bNeedToRefreshGui = gui;};
     
@@ -283,12 +278,6 @@ public:
     
     void restoreCurrentLocations();
     
-    //this is to update positions on resize, based on new radius
-    void updatePositions();
-    
-    //radius of the dome
-    static int s_iDomeRadius;
-    
     static bool s_bForceConstraintAutomation;
     
     bool isTrajectoryDone();
@@ -297,22 +286,24 @@ public:
     void setTrajectory(Trajectory::Ptr t) { mTrajectory = t; }
   	Trajectory::Ptr getTrajectory() { return mTrajectory; }
     
-    void askForGuiRefresh(){m_bNeedToRefreshGui=true;};
+    void askForGuiRefresh(){
+        m_bNeedToRefreshGui = true;
+        m_oGuiRefreshBroadcaster.sendChangeMessage();
+    }
+    //! flag source p_iSource as changed for the editor's source list, then ask for a refresh. Safe on the audio thread
+    void askForSourceRefresh(int p_iSource);
+    void askForAllSourcesRefresh();
+    //! sources changed since the last call
+    SourceSet takeChangedSources(){
+        return m_oChangedSources.take();
+    }
     
     void setIsRecordingAutomation(bool b){
         m_bIsRecordingAutomation = b;
     }
     
-    //! get the source order by the angle value
-    std::vector<int> getOrderSources();
-
-    void setEqualAzimForAllSrc();
-    void setEqualElevForAllSrc();
-    void setSymmetricForAllSrc();
-    
-    void setEqualAzimElevForAllSrc();
-    
-    void setCurrentAndOldLocation(const int &p_iSrc, const float &p_fX01, const float &p_fY01);
+    //! move the other sources to where the current constraint places them relative to the selected source, if it does
+    void enforceMovementConstraint();
     
     void updateSourcesSendOsc();
     
@@ -343,17 +334,66 @@ public:
     void setDampening(double Dampening){
         m_dTrajectoryDampening = Dampening;
     }
+    double getRandomSpeed(){
+        return m_dRandomSpeed;
+    }
+    void setRandomSpeed(double speed){
+        m_dRandomSpeed = speed;
+    }
+    double getRandomRoughness(){
+        return m_dRandomRoughness;
+    }
+    void setRandomRoughness(double roughness){
+        m_dRandomRoughness = roughness;
+    }
+    const TrajectorySpline& getDrawnSpline(){
+        return m_oDrawnSpline;
+    }
+    void setDrawnSpline(const TrajectorySpline &spline){
+        m_oDrawnSpline = spline;
+    }
+    int getRandomSeed(){
+        return m_iRandomSeed;
+    }
+    void setRandomSeed(int seed){
+        m_iRandomSeed = seed;
+    }
     
     void connectOsc(int p);
     
+    //SNAPSHOTS
+    int getNbrSnapshots(){
+        return m_oSnapshots.size();
+    }
+    String getSnapshotName(int p_iSnapshot){
+        return m_oSnapshots.getName(p_iSnapshot);
+    }
+    int getSnapshotIndex(const String &p_sName){
+        return m_oSnapshots.indexOf(p_sName);
+    }
+    //! store all sources as p_sName, replacing the snapshot with that name if there is one. Returns false if there is no room left
+    bool storeSnapshot(const String &p_sName);
+    //! move all sources to snapshot p_iSnapshot and tell the host
+    void recallSnapshot(int p_iSnapshot);
+    void deleteSnapshot(int p_iSnapshot);
+    
+    //! positions of the moved sources, drained by the editor to draw the trail
+    PositionTrace& getPositionTrace(){
+        return m_oPositionTrace;
+    }
+    //! counters shown by the editor's performance overlay
+    ProcessorPerformance& getPerformance(){
+        return m_oPerformance;
+    }
+    
 private:
     
     void initSources();
     void processTrajectories();
     void stopTrajectory();
-    void moveCircular(const int &p_iSource, const float &p_fX, const float &p_fY, const float &p_fAzim01 = -1, const float &p_fElev01 = -1);
-    void moveDelta(const int &p_iSource, const float &p_fX, const float &p_fY);
-    void moveSymmetric(const int &p_iSource, const float &p_fX, const float &p_fY);
+    //! move the other sources with the current constraint, after p_iLeader moved from its previous location to where it is now.
+    //! With p_bEnforce, only move them to where the constraint places them relative to p_iLeader, and tell the host
+    void solveMovementConstraint(int p_iLeader, bool p_bEnforce);
     bool setPositionParameters(int index, float newValue);
     bool setOtherParameters(int index, float newValue);
 
@@ -362,6 +402,8 @@ private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ZirkOscAudioProcessor)
     //! Whether the editor has to refresh the GUI
     bool m_bNeedToRefreshGui = false;
+    ChangeBroadcaster m_oGuiRefreshBroadcaster;
+    AtomicSourceSet m_oChangedSources;
     //! Current number of sources on the screnn
     int m_iNbrSources;
     //! float ID of the selected movement constraint
@@ -383,6 +425,10 @@ private:
     SoundSource m_oAllSources [8];
     //Copy of all sources to be able to save and restore locations before and after a trajectory
     SoundSource m_oAllSourcesBuffer [8];
+    //! sources sorted by azimuth, for the equal azimuth constraints
+    AzimuthOrder m_oAzimuthOrder;
+    //! solveMovementConstraint runs on the audio, source update and message threads, and m_oAzimuthOrder is kept between solves
+    CriticalSection m_oConstraintLock;
     
 
     
@@ -408,10 +454,6 @@ private:
     
     PluginHostType host;
     
-    std::pair<float, float> getDeltasForSelectedSource(const int &p_iSource, const float &p_fSelectedNewX, const float &p_fSelectedNewY, const float &p_fAzim01, const float &p_fElev01);
-    std::pair<float, float> getCurrentSourcePosition(int iCurSource);
-    std::tuple<float, float, float, float> getNewSourcePosition(const int &p_iSource, const float &fSelectedDeltaAzim01, const float &fSelectedDeltaElev01,
-                                            const int &iCurSource, const float &fCurAzim01, const float &fCurElev01);
     int m_iActualConstraint;
     
     double m_dTrajectoryCount;
@@ -419,6 +461,23 @@ private:
     double m_dTrajectoryTurns;
     double m_dTrajectoryDeviation;
     double m_dTrajectoryDampening;
+    //! random trajectory speed, in noise cycles per second or per beat
+    double m_dRandomSpeed;
+    //! random trajectory roughness in [0,1], 0 being the smoothest
+    double m_dRandomRoughness;
+    //! seed for the random trajectory; writing twice with the same seed gives the same automation
+    int    m_iRandomSeed;
+    //! gesture drawn on the dome, replayed by the drawn trajectory
+    TrajectorySpline m_oDrawnSpline;
+    SourceSnapshots m_oSnapshots;
+    PositionTrace m_oPositionTrace;
+    ProcessorPerformance m_oPerformance;
+    //! scratch arrays for the morph, which runs on the audio thread
+    SourceGroup m_oMorphGroup;
+    //! position along the snapshots, [0,1]. Set by the host and the editor, read by the audio thread
+    Atomic<float> m_fMorph;
+    //! morph the sources were last moved to. Only a change of m_fMorph moves them, so storing or deleting snapshots does not
+    Atomic<float> m_fAppliedMorph;
     bool   m_bIsSyncWTempo;
     bool   m_bIsWriteTrajectory;
     
@@ -0,0 +1,108 @@
+/*
+ ==============================================================================
+ ZirkOSC: VST and AU audio plug-in enabling spatial movement of sound sources in a dome of speakers.
+
+ Copyright (C) 2015  GRIS-UdeM
+
+ Developers: Ludovic Laffineur, Vincent Berthiaume
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ==============================================================================
+ */
+
+
+#include "PositionTrace.h"
+
+namespace {
+    //! trail points closer than this, in dome coordinates, are skipped
+    const float  kfMinDistance  = .01f;
+    const uint32 kiFadeMs       = 4000;
+}
+
+void PositionTrace::push(float p_fX, float p_fY){
+    if (!m_iPushing.compareAndSetBool(1, 0)){
+        return;
+    }
+    int iStart1, iSize1, iStart2, iSize2;
+    m_oFifo.prepareToWrite(1, iStart1, iSize1, iStart2, iSize2);
+    if (iSize1 > 0){
+        TracePoint &oPoint = m_aPoints[iStart1];
+        oPoint.m_fX      = p_fX;
+        oPoint.m_fY      = p_fY;
+        oPoint.m_iTimeMs = Time::getMillisecondCounter();
+        m_oFifo.finishedWrite(1);
+    }
+    m_iPushing = 0;
+}
+
+int PositionTrace::pop(TracePoint *p_pPoints, int p_iMax){
+    int iStart1, iSize1, iStart2, iSize2;
+    m_oFifo.prepareToRead(p_iMax, iStart1, iSize1, iStart2, iSize2);
+    for (int i = 0; i < iSize1; ++i){
+        p_pPoints[i] = m_aPoints[iStart1 + i];
+    }
+    for (int i = 0; i < iSize2; ++i){
+        p_pPoints[iSize1 + i] = m_aPoints[iStart2 + i];
+    }
+    m_oFifo.finishedRead(iSize1 + iSize2);
+    return iSize1 + iSize2;
+}
+
+void PositionTrace::discard(){
+    m_oFifo.finishedRead(m_oFifo.getNumReady());
+}
+
+void PositionTrail::add(const TracePoint &p_oPoint){
+    if (m_iCount > 0){
+        const TracePoint &oLast = get(m_iCount - 1);
+        if (hypotf(p_oPoint.m_fX - oLast.m_fX, p_oPoint.m_fY - oLast.m_fY) < kfMinDistance){
+            return;
+        }
+    }
+    if (m_iCount == s_kiMaxPoints){
+        m_iFirst = (m_iFirst + 1) % s_kiMaxPoints;
+        --m_iCount;
+    }
+    m_aPoints[(m_iFirst + m_iCount) % s_kiMaxPoints] = p_oPoint;
+    ++m_iCount;
+}
+
+bool PositionTrail::update(PositionTrace &p_oTrace, uint32 p_iNowMs){
+    bool bChanged = false;
+    TracePoint aPoints[64];
+    for (int iRead; (iRead = p_oTrace.pop(aPoints, numElementsInArray(aPoints))) > 0; ){
+        for (int i = 0; i < iRead; ++i){
+            add(aPoints[i]);
+        }
+        bChanged = true;
+    }
+    while (m_iCount > 0 && p_iNowMs - get(0).m_iTimeMs > kiFadeMs){
+        m_iFirst = (m_iFirst + 1) % s_kiMaxPoints;
+        --m_iCount;
+        bChanged = true;
+    }
+    //the remaining segments keep fading
+    return bChanged || m_iCount > 1;
+}
+
+void PositionTrail::paint(Graphics &g, Point<float> p_oCenter, float p_fRadius, Colour p_oColour, uint32 p_iNowMs) const {
+    for (int i = 1; i < m_iCount; ++i){
+        const TracePoint &oFrom = get(i - 1);
+        const TracePoint &oTo   = get(i);
+        const uint32 iAge = jmin(p_iNowMs - oTo.m_iTimeMs, kiFadeMs);
+        g.setColour(p_oColour.withMultipliedAlpha(1 - static_cast<float>(iAge) / kiFadeMs));
+        g.drawLine(p_oCenter.x + oFrom.m_fX * p_fRadius, p_oCenter.y + oFrom.m_fY * p_fRadius,
+                   p_oCenter.x + oTo.m_fX   * p_fRadius, p_oCenter.y + oTo.m_fY   * p_fRadius, 2.0f);
+    }
+}
@@ -0,0 +1,91 @@
+/*
+ ==============================================================================
+ ZirkOSC: VST and AU audio plug-in enabling spatial movement of sound sources in a dome of speakers.
+
+ Copyright (C) 2015  GRIS-UdeM
+
+ Developers: Ludovic Laffineur, Vincent Berthiaume
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ==============================================================================
+ */
+
+
+#ifndef __ZirkOSCJUCE__PositionTrace__
+#define __ZirkOSCJUCE__PositionTrace__
+
+#include "../JuceLibraryCode/JuceHeader.h"
+
+//! A source position in dome coordinates, with the time it was reached
+struct TracePoint {
+    float   m_fX;
+    float   m_fY;
+    uint32  m_iTimeMs;
+};
+
+//! Positions of the moving source, handed from whichever thread moves it to the editor. Pushing never blocks or allocates:
+//! when the editor is closed or late, the ring fills up and new points are dropped. A push that starts while another
+//! one is in progress (eg, OSC while the audio thread writes a trajectory) also drops its point instead of waiting,
+//! so the ring always sees a single producer. The editor is the only consumer.
+class PositionTrace {
+public:
+    PositionTrace()
+    :m_oFifo(s_kiCapacity)
+    {}
+    
+    void push(float p_fX, float p_fY);
+    //! copy up to p_iMax pending points into p_pPoints, oldest first, and return how many were copied
+    int pop(TracePoint *p_pPoints, int p_iMax);
+    //! throw away the pending points, from the consumer side
+    void discard();
+    
+private:
+    static const int s_kiCapacity = 512;
+    AbstractFifo m_oFifo;
+    TracePoint m_aPoints[s_kiCapacity];
+    Atomic<int> m_iPushing;
+    
+    JUCE_DECLARE_NON_COPYABLE (PositionTrace)
+};
+
+//! The trail drawn behind the moving source: the last s_kiMaxPoints points of the trace, at least a minimum distance apart,
+//! fading out with age. Its size is bounded, so painting it costs the same however long the movement lasts. Points stay in
+//! dome coordinates, so the trail survives resizing.
+class PositionTrail {
+public:
+    PositionTrail()
+    :m_iFirst(0)
+    ,m_iCount(0)
+    {}
+    
+    //! drain p_oTrace into the trail and drop faded points. Returns true if the trail needs to be repainted
+    bool update(PositionTrace &p_oTrace, uint32 p_iNowMs);
+    void clear(){
+        m_iFirst = m_iCount = 0;
+    }
+    void paint(Graphics &g, Point<float> p_oCenter, float p_fRadius, Colour p_oColour, uint32 p_iNowMs) const;
+    
+private:
+    void add(const TracePoint &p_oPoint);
+    const TracePoint& get(int p_iPoint) const {
+        return m_aPoints[(m_iFirst + p_iPoint) % s_kiMaxPoints];
+    }
+    
+    static const int s_kiMaxPoints = 256;
+    TracePoint m_aPoints[s_kiMaxPoints];
+    int m_iFirst;
+    int m_iCount;
+};
+
+#endif /* defined(__ZirkOSCJUCE__PositionTrace__) */
@@ -25,6 +25,7 @@
 #include "SoundSource.h"
 #include "ZirkConstants.h"
 #include "PluginProcessor.h"
+#include "Tools.h"
 
 
 SoundSource::SoundSource()
@@ -32,10 +33,17 @@ SoundSource::SoundSource()
 , m_fGain(1.f)
 , m_fAzimuthSpan(0.f)
 , m_fElevationSpan(0.f)
-, m_bElevationWasMaxed(false)
+, m_fX(0.f)
+, m_fY(0.f)
+, m_fAzim01(0.f)
+, m_fElev01(0.f)
+, m_bXYValid(false)
+, m_bAzimElevValid(true)
+, m_fGroupAzim01(0.f)
+, m_fGroupElev01(0.f)
+, m_bGroupVectorValid(false)
 {
-    m_iElevationStatus = normalRange;
-    m_fElevOverflow = ZirkOscAudioProcessor::s_iDomeRadius;
+    updatePosition();
 }
 
 SoundSource::SoundSource(float p_fAzim01, float elevation, int p_iSrcId)
@@ -47,61 +55,82 @@ SoundSource::SoundSource(float p_fAzim01, float elevation, int p_iSrcId)
 void SoundSource::initAzimuthAndElevation(float p_fAzim, float p_fElev){
     setAzim01SanityCheck(checkAndFixAzim01Bounds(p_fAzim));
     setElev01SanityCheck(p_fElev);
-    setXYUsingAzimElev01(p_fAzim, p_fElev);
+    m_bAzimElevValid = true;
+    m_bXYValid = false;
 }
 
 SoundSource::~SoundSource(){
 }
 
 //----------------------------------------- PRIVATE UTILITY FUNCTIONS ------------------------------
-void SoundSource::setXYUsingAzimElev01(float p_fAzim01, float p_fElev01){
-    float HRAzimuth     = PercentToHR(p_fAzim01, ZirkOSC_Azim_Min,ZirkOSC_Azim_Max);
-    float HRElevation   = PercentToHR(p_fElev01, ZirkOSC_Elev_Min, ZirkOSC_Elev_Max);
-    m_fX = (- ZirkOscAudioProcessor::s_iDomeRadius * sinf(degreeToRadian(HRAzimuth)) * cosf(degreeToRadian(HRElevation)));
-    m_fY = (-ZirkOscAudioProcessor::s_iDomeRadius * cosf(degreeToRadian(HRAzimuth)) * cosf(degreeToRadian(HRElevation)));
+void SoundSource::ensureXY(){
+    if (!m_bXYValid){
+        azimElev01toXY(m_fAzim01, m_fElev01, m_fX, m_fY);
+        m_bXYValid = true;
+    }
+}
+    //in theory deriving azim and elev from xy should never be needed, since it can be invalid when x,y == 0,0. In case of delta lock though (and probably other cases), we can't avoid it
+void SoundSource::ensureAzimElev(){
+    if (!m_bAzimElevValid){
+        setAzim01SanityCheck(checkAndFixAzim01Bounds(XYtoAzim01(m_fX, m_fY)));
+        setElev01SanityCheck(XYtoElev01(m_fX, m_fY));
+        m_bAzimElevValid = true;
+    }
 }
-    //in theory this updateAzimElev() should never be used, since it can be invalid when x,y == 0,0. In case of delta lock though (and probably other cases), we can't avoid it
 void SoundSource::updateAzimElev(){
-    setAzim01SanityCheck(checkAndFixAzim01Bounds(XYtoAzim01(m_fX, m_fY)));
-    setElev01SanityCheck(XYtoElev01(m_fX, m_fY));
+    ensureXY();
+    m_bAzimElevValid = false;
+}
+void SoundSource::synchronize(){
+    ensureXY();
+    ensureAzimElev();
 }
 //------------------------------------------ SETTERS -------------------------------------------------
-void SoundSource::setXY(Point <float> p){    //x and y are [-r,r]
+void SoundSource::setXY(Point <float> p){    //x and y are [-1,1]
     m_fX = p.x;
     m_fY = p.y;
+    m_bXYValid = true;
+    m_bAzimElevValid = false;
 }
 
 void SoundSource::setXYAzimElev01(const float &p_x01, const float &p_y01, const float &p_fAzim01, const float &p_fElev01){
-    m_fX = PercentToHR(p_x01, -ZirkOscAudioProcessor::s_iDomeRadius, ZirkOscAudioProcessor::s_iDomeRadius);
-    m_fY = PercentToHR(p_y01, -ZirkOscAudioProcessor::s_iDomeRadius, ZirkOscAudioProcessor::s_iDomeRadius);
+    m_fX = PercentToHR(p_x01, -1, 1);
+    m_fY = PercentToHR(p_y01, -1, 1);
+    m_bXYValid = true;
     if (p_fAzim01 != -1 && p_fElev01 != -1){
         setAzim01SanityCheck(p_fAzim01);
         setElev01SanityCheck(p_fElev01);
+        m_bAzimElevValid = true;
     } else {
-        updateAzimElev();
+        m_bAzimElevValid = false;
     }
 }
 void SoundSource::setX01(float p_x01){
-    m_fX = PercentToHR(p_x01, -ZirkOscAudioProcessor::s_iDomeRadius, ZirkOscAudioProcessor::s_iDomeRadius);
-    updateAzimElev();
+    ensureXY();
+    m_fX = PercentToHR(p_x01, -1, 1);
+    m_bAzimElevValid = false;
 }
 void SoundSource::setY01(float p_y01){
-    m_fY = PercentToHR(p_y01, -ZirkOscAudioProcessor::s_iDomeRadius, ZirkOscAudioProcessor::s_iDomeRadius);
-    updateAzimElev();
+    ensureXY();
+    m_fY = PercentToHR(p_y01, -1, 1);
+    m_bAzimElevValid = false;
 }
 
 void SoundSource::updatePosition(){
-    azimElev01toXY(m_fAzim01, m_fElev01, m_fX, m_fY);
+    ensureAzimElev();
+    m_bXYValid = false;
 }
 
 //----------------------- AZIM + ELEV
 void  SoundSource::setAzimuth01(float azimuth01){
+    ensureAzimElev();
     setAzim01SanityCheck(checkAndFixAzim01Bounds(azimuth01));
-    setXYUsingAzimElev01(getAzimuth01(), getElevation01());
+    m_bXYValid = false;
 }
 void SoundSource::setElevation01(float elevation01){
+    ensureAzimElev();
     m_fElev01 = elevation01;
-    setXYUsingAzimElev01(getAzimuth01(), elevation01);
+    m_bXYValid = false;
 }
 
 void SoundSource::setAzim01SanityCheck(float p_fAzim01){
@@ -128,18 +157,54 @@ void SoundSource::setPrevLoc01(const float &p_fX01, const float &p_fY01, const f
     }
 }
 
+ZirkVector3 SoundSource::getGroupVector(){
+    const float fEpsilon = 1e-4f;
+    float fAzim01 = getAzimuth01();
+    float fElev01 = getElevation01();
+    if (m_bGroupVectorValid && fabsf(fAzim01 - m_fGroupAzim01) < fEpsilon && fabsf(fElev01 - m_fGroupElev01) < fEpsilon){
+        return m_oGroupVector;
+    }
+    return azimElev01toVector(fAzim01, fElev01);
+}
+
+void SoundSource::setGroupVector(const ZirkVector3 &p_oVector){
+    float fX01, fY01, fAzim01, fElev01;
+    vectorToPosition01(p_oVector, fX01, fY01, fAzim01, fElev01);
+    setGroupPosition(p_oVector, fX01, fY01, fAzim01, fElev01);
+}
+
+void SoundSource::setGroupPosition(const ZirkVector3 &p_oVector, const float &p_fX01, const float &p_fY01, const float &p_fAzim01, const float &p_fElev01){
+    setXYAzimElev01(p_fX01, p_fY01, p_fAzim01, p_fElev01);
+    setPrevLoc01(p_fX01, p_fY01, p_fAzim01, p_fElev01);
+    m_oGroupVector = p_oVector;
+    m_fGroupAzim01 = p_fAzim01;
+    m_fGroupElev01 = p_fElev01;
+    m_bGroupVectorValid = true;
+}
+
 //------------------------------------------ GETTERS -------------------------------------------------
+//a stale form is converted into locals, never into the members
+float SoundSource::getX(){
+    float fX, fY;
+    getXY(fX, fY);
+    return fX;
+}
+float SoundSource::getY(){
+    float fX, fY;
+    getXY(fX, fY);
+    return fY;
+}
 float SoundSource::getX01(){
-    return HRToPercent(m_fX, -ZirkOscAudioProcessor::s_iDomeRadius, ZirkOscAudioProcessor::s_iDomeRadius);
+    return HRToPercent(getX(), -1, 1);
 }
 float SoundSource::getY01(){
-    return HRToPercent(m_fY, -ZirkOscAudioProcessor::s_iDomeRadius, ZirkOscAudioProcessor::s_iDomeRadius);
+    return HRToPercent(getY(), -1, 1);
 }
 float   SoundSource::getAzimuth01(){
-    return m_fAzim01;
+    return m_bAzimElevValid ? m_fAzim01 : checkAndFixAzim01Bounds(XYtoAzim01(m_fX, m_fY));
 }
 float   SoundSource::getElevation01(){
-    return m_fElev01;
+    return m_bAzimElevValid ? m_fElev01 : XYtoElev01(m_fX, m_fY);
 }
 JUCE_COMPILER_WARNING("use a pair for this")
 void SoundSource::getPrevXY01(float &p_fX01, float &p_fY01){
@@ -152,63 +217,83 @@ float SoundSource::getPrevAzim01(){
 float SoundSource::getPrevElev01(){
     return m_fPrevElev01;
 }
-//range for both fX and fY is [-r,r]
+//range for both fX and fY is [-1,1]
 void SoundSource::getXY(float &fX, float &fY){
-    fX = getX();
-    fY = getY();
+    if (m_bXYValid){
+        fX = m_fX;
+        fY = m_fY;
+    } else {
+        azimElev01toXY(m_fAzim01, m_fElev01, fX, fY);
+    }
 }
 
 
 //-------------------------- STATIC CONVERSION FUNCTIONS --------------------------
 void SoundSource::azimElev01toXY01(const float &p_fAzimuth01, const float &p_fElevation01, float &p_fX, float &p_fY){
-    float HRAzimuth   = PercentToHR(p_fAzimuth01,   ZirkOSC_Azim_Min, ZirkOSC_Azim_Max);
-    float HRElevation = PercentToHR(p_fElevation01, ZirkOSC_Elev_Min, ZirkOSC_Elev_Max);
-    
-    p_fX = -ZirkOscAudioProcessor::s_iDomeRadius * sin(degreeToRadian(HRAzimuth)) * cos(degreeToRadian(HRElevation));
-    p_fX = (p_fX + ZirkOscAudioProcessor::s_iDomeRadius) / (2.f*ZirkOscAudioProcessor::s_iDomeRadius);
-    p_fY = -ZirkOscAudioProcessor::s_iDomeRadius * cos(degreeToRadian(HRAzimuth)) * cos(degreeToRadian(HRElevation));
-    p_fY = (p_fY + ZirkOscAudioProcessor::s_iDomeRadius) / (2.f*ZirkOscAudioProcessor::s_iDomeRadius);
+    azimElev01toXY01(p_fAzimuth01, p_fElevation01, p_fX, p_fY, 1.f);
 }
 
 void SoundSource::azimElev01toXY01(const float &p_fAzimuth01, const float &p_fElevation01, float &p_fX, float &p_fY, const float& fNewR){
-    float HRAzimuth   = PercentToHR(p_fAzimuth01,   ZirkOSC_Azim_Min, ZirkOSC_Azim_Max);
-    float HRElevation = PercentToHR(p_fElevation01, ZirkOSC_Elev_Min, ZirkOSC_Elev_Max);
+    float fAzimuth   = PercentToHR(p_fAzimuth01,   ZirkOSC_Azim_Min, ZirkOSC_Azim_Max) * ZirkMath::kDegreeToRadian;
+    float fElevation = PercentToHR(p_fElevation01, ZirkOSC_Elev_Min, ZirkOSC_Elev_Max) * ZirkMath::kDegreeToRadian;
+    float fCosElev   = ZirkMath::cos(fElevation);
     
-    p_fX = -fNewR * sin(degreeToRadian(HRAzimuth)) * cos(degreeToRadian(HRElevation));
-    p_fX = (p_fX + ZirkOscAudioProcessor::s_iDomeRadius) / (2.f*ZirkOscAudioProcessor::s_iDomeRadius);
-    p_fY = -fNewR * cos(degreeToRadian(HRAzimuth)) * cos(degreeToRadian(HRElevation));
-    p_fY = (p_fY + ZirkOscAudioProcessor::s_iDomeRadius) / (2.f*ZirkOscAudioProcessor::s_iDomeRadius);
+    p_fX = -fNewR * ZirkMath::sin(fAzimuth) * fCosElev;
+    p_fX = (p_fX + 1) / 2;
+    p_fY = -fNewR * ZirkMath::cos(fAzimuth) * fCosElev;
+    p_fY = (p_fY + 1) / 2;
 }
 void SoundSource::azimElev01toXY(const float &p_fAzimuth01, const float &p_fElevation01, float &p_fX, float &p_fY){
-    float HRAzimuth   = PercentToHR(p_fAzimuth01,   ZirkOSC_Azim_Min, ZirkOSC_Azim_Max);
-    float HRElevation = PercentToHR(p_fElevation01, ZirkOSC_Elev_Min, ZirkOSC_Elev_Max);
-    
-    p_fX = -ZirkOscAudioProcessor::s_iDomeRadius * sinf(degreeToRadian(HRAzimuth)) * cosf(degreeToRadian(HRElevation));
-    p_fY = -ZirkOscAudioProcessor::s_iDomeRadius * cosf(degreeToRadian(HRAzimuth)) * cosf(degreeToRadian(HRElevation));
+    azimElevToXy(PercentToHR(p_fAzimuth01, ZirkOSC_Azim_Min, ZirkOSC_Azim_Max), PercentToHR(p_fElevation01, ZirkOSC_Elev_Min, ZirkOSC_Elev_Max), p_fX, p_fY);
 }
 //XY are [0,1] and azim+elev are [0,1]
 void SoundSource::XY01toAzimElev01(const float &p_fX, const float &p_fY, float &p_fAzim, float &p_fElev){
-    float fX = p_fX * 2 * ZirkOscAudioProcessor::s_iDomeRadius - ZirkOscAudioProcessor::s_iDomeRadius;
-    float fY = p_fY * 2 * ZirkOscAudioProcessor::s_iDomeRadius - ZirkOscAudioProcessor::s_iDomeRadius;
+    float fX = p_fX * 2 - 1;
+    float fY = p_fY * 2 - 1;
     
 //    jassert(p_fX != 0);
     
     p_fAzim = XYtoAzim01(fX, fY);
     p_fElev = XYtoElev01(fX, fY);
 }
-// azim elev in degrees and xy in range [-r, r]
+// azim elev in degrees and xy in range [-1, 1]
 void SoundSource::azimElevToXy (const float &p_fAzimuth, const float &p_fElevation, float &p_fX, float &p_fY){
-    p_fX = -ZirkOscAudioProcessor::s_iDomeRadius * sinf(degreeToRadian(p_fAzimuth)) * cosf(degreeToRadian(p_fElevation));
-    p_fY = -ZirkOscAudioProcessor::s_iDomeRadius * cosf(degreeToRadian(p_fAzimuth)) * cosf(degreeToRadian(p_fElevation));
+    float fAzimuth  = p_fAzimuth * ZirkMath::kDegreeToRadian;
+    float fCosElev = ZirkMath::cos(p_fElevation * ZirkMath::kDegreeToRadian);
+    p_fX = -fCosElev * ZirkMath::sin(fAzimuth);
+    p_fY = -fCosElev * ZirkMath::cos(fAzimuth);
+}
+ZirkVector3 SoundSource::azimElev01toVector(const float &p_fAzim01, const float &p_fElev01){
+    float fAzimuth   = PercentToHR(p_fAzim01, ZirkOSC_Azim_Min, ZirkOSC_Azim_Max) * ZirkMath::kDegreeToRadian;
+    float fElevation = PercentToHR(p_fElev01, ZirkOSC_Elev_Min, ZirkOSC_Elev_Max) * ZirkMath::kDegreeToRadian;
+    float fCosElev   = ZirkMath::cos(fElevation);
+    return { -fCosElev * ZirkMath::sin(fAzimuth), -fCosElev * ZirkMath::cos(fAzimuth), ZirkMath::sin(fElevation) };
+}
+void SoundSource::vectorToPosition01(const ZirkVector3 &p_oVector, float &p_fX01, float &p_fY01, float &p_fAzim01, float &p_fElev01){
+    const float fRadiusXY = sqrtf(p_oVector.x*p_oVector.x + p_oVector.y*p_oVector.y);
+    p_fAzim01 = checkAndFixAzim01Bounds(XYtoAzim01(p_oVector.x, p_oVector.y));
+    float fScale;
+    if (p_oVector.z <= 0){
+        //on the horizon, in the direction of the vector
+        p_fElev01 = 0;
+        fScale = fRadiusXY > 0 ? 1 / fRadiusXY : 0;
+    } else {
+        //atan2 keeps its precision near the zenith, where acos of the xy radius does not
+        p_fElev01 = jmin(1.f, ZirkMath::atan2(p_oVector.z, fRadiusXY) / ZirkMath::kHalfPi);
+        fScale = 1 / sqrtf(fRadiusXY*fRadiusXY + p_oVector.z*p_oVector.z);
+    }
+    //the vector seen from above is already the dome xy, no need to go back through the angles
+    p_fX01 = (p_oVector.x * fScale + 1) / 2;
+    p_fY01 = (p_oVector.y * fScale + 1) / 2;
 }
-//XY are [-r,r] and azim is [0,1]
+//XY are [-1,1] and azim is [0,1]
 float SoundSource::XYtoAzim01(const float &p_fX, const float &p_fY){
     float azim;
     if (p_fX > 0){
-        azim = atan2f(p_fX, p_fY);
+        azim = ZirkMath::atan2(p_fX, p_fY);
     } else {
-        azim = atan2f(-p_fX, p_fY);
-        azim = 2*M_PI-azim;
+        azim = ZirkMath::atan2(-p_fX, p_fY);
+        azim = ZirkMath::kTwoPi - azim;
     }
 //    if(azim < .002){
 //        if (azim > .00001){
@@ -219,27 +304,25 @@ float SoundSource::XYtoAzim01(const float &p_fX, const float &p_fY){
 //            return 1;
 //        }
 //    } else {
-        azim *= 180/M_PI;
-        azim /= 360;
-        return azim;
+        return azim / ZirkMath::kTwoPi;
 //    }
 }
 float SoundSource::XYtoElev01(const float &p_fX, const float &p_fY){
-    double dArg = sqrt(p_fX*p_fX + p_fY*p_fY) / ZirkOscAudioProcessor::s_iDomeRadius;
-    if (dArg > 1) {
-        dArg =  1.;
-    } else if (dArg < .001){
-        dArg = 0.;
+    float fArg = sqrtf(p_fX*p_fX + p_fY*p_fY);
+    if (fArg > 1) {
+        fArg =  1.f;
+    } else if (fArg < .001f){
+        fArg = 0.f;
     }
-    float fElevation = static_cast<float>(acos(dArg)) ;
-    if (fElevation < 0.001){
+    float fElevation = ZirkMath::acos(fArg);
+    if (fElevation < 0.001f){
         return 0.f;
     } else {
-        return (fElevation) / M_PI_2;
+        return fElevation / ZirkMath::kHalfPi;
     }
 }
-//clamp x and y to [-r. r]
+//clamp x and y to [-1, 1]
 void SoundSource::clampXY(float &p_fx, float &p_fy){
-    p_fx = clamp(p_fx, -static_cast<float>(ZirkOscAudioProcessor::s_iDomeRadius), static_cast<float>(ZirkOscAudioProcessor::s_iDomeRadius));
-    p_fy = clamp(p_fy, -static_cast<float>(ZirkOscAudioProcessor::s_iDomeRadius), static_cast<float>(ZirkOscAudioProcessor::s_iDomeRadius));
+    p_fx = clamp(p_fx, -1.f, 1.f);
+    p_fy = clamp(p_fy, -1.f, 1.f);
 }
\ No newline at end of file
@@ -27,6 +27,7 @@
 #include <iostream>
 #include "../JuceLibraryCode/JuceHeader.h"
 #include "ZirkConstants.h"
+#include "Tools.h"
 class SoundSource{
 public:
     SoundSource();
@@ -34,7 +35,7 @@ public:
     void    initAzimuthAndElevation(float p_fAzim, float p_fElev);
     ~SoundSource();
     //POSITION FUNCTIONS
-    void    setXY(Point <float>);       //set x and y, both are [-r,r]
+    void    setXY(Point <float>);       //set x and y, both are [-1,1]
     void    getXY(float &fX, float &fY);
     void    setX01(float x);
     void    setY01(float y);
@@ -49,8 +50,13 @@ public:
     void    getPrevXY01(float &p_fX01, float &p_fY01);
     float   getPrevAzim01();
     float   getPrevElev01();
+    //! make xy the authoritative position, azimuth and elevation are derived from it when next needed
     void    updateAzimElev();
+    //! make azimuth and elevation the authoritative position, xy is derived from them when next needed
     void    updatePosition();
+    //! store the form the last setters left stale, so reads stop converting it. Call it from the thread that writes the source,
+    //! once its writes are done
+    void    synchronize();
     
     //TRIVIAL SETTERS AND GETTERS
     float getGain01(){
@@ -65,18 +71,13 @@ public:
     void setSourceId(int iSourceId){
         m_iSourceId = iSourceId;
     }
-    void setElevationStatus(ElevationStatus status){
-        m_iElevationStatus = status;
-    }
-    ElevationStatus getElevationStatus(){
-        return m_iElevationStatus;
-    }
-    void setElevOverflow(const float &p_fElevOverflow){
-        m_fElevOverflow = p_fElevOverflow;
-    }
-    float getElevOverflow(){
-        return m_fElevOverflow;
-    }
+    //! position as a unit vector, for group moves. Unlike azimuth and elevation it can go past the zenith or under the horizon.
+    //! It is kept as long as the source stays where the last group move left it, otherwise it is rebuilt from the current position
+    ZirkVector3 getGroupVector();
+    //! store p_oVector and move the source to where it is seen on the dome: straight below it, or on the horizon when it is under it
+    void setGroupVector(const ZirkVector3 &p_oVector);
+    //! same as setGroupVector, with the position already computed by vectorToPosition01. Also sets the previous location
+    void setGroupPosition(const ZirkVector3 &p_oVector, const float &p_fX01, const float &p_fY01, const float &p_fAzim01, const float &p_fElev01);
     float getAzimuthSpan(){
         return m_fAzimuthSpan;
     }
@@ -90,17 +91,10 @@ public:
     void setElevationSpan(float elevation_span){
         m_fElevationSpan = elevation_span;
     }
-    bool contains(Point <float> p){
-        return (p.getX()< getX()+10 && p.getX()> getX()-10 && p.getY()< getY()+10 && p.getY()> getY()-10 );
-    }
-    //returned x is [-r,r]
-    float getX(){
-        return m_fX;
-    }
-    //returned y is [-r,r]
-    float getY(){
-        return m_fY;
-    }
+    //returned x is [-1,1], ie on the unit circle when the elevation is 0
+    float getX();
+    //returned y is [-1,1]
+    float getY();
 
     //STATIC CONVERTION FONCTIONS
     static float XYtoAzim01(const float &x, const float &y);
@@ -110,17 +104,27 @@ public:
     static void azimElev01toXY01(const float &p_fAzimuth01, const float &p_fElevation01, float &p_fX, float &p_fY, const float& fNewR);
     static void azimElev01toXY(const float &p_fAzim, const float &p_fElev, float &p_fX, float &p_fY);
     static void azimElevToXy (const float &p_fAzimuth, const float &p_fElevation, float &p_fX, float &p_fY);
+    static ZirkVector3 azimElev01toVector(const float &p_fAzim01, const float &p_fElev01);
+    //! where p_oVector is seen on the dome: xy and azimuth+elevation, all [0,1]. Vectors under the horizon are put on it,
+    //! and the vector does not need to be of unit length
+    static void vectorToPosition01(const ZirkVector3 &p_oVector, float &p_fX01, float &p_fY01, float &p_fAzim01, float &p_fElev01);
     static void clampXY(float &x, float &y);
 private:
     int   m_iSourceId;         //! Source id sent to Zirkonium
     float m_fGain;
     float m_fAzimuthSpan;
     float m_fElevationSpan;
-    //position parameters (x,y and azim,elev are redundant with each other)
+    //position parameters (x,y and azim,elev are redundant with each other). Setters only write one of the 2 forms and mark the
+    //other stale, so eg setX01 followed by setY01 costs no conversion. The editor, audio and OSC threads all read sources, so
+    //getters never write: they convert a stale form on the fly, until the writer stores it with synchronize()
     float m_fX;
     float m_fY;
     float m_fAzim01;
     float m_fElev01;
+    bool  m_bXYValid;
+    bool  m_bAzimElevValid;
+    void  ensureXY();
+    void  ensureAzimElev();
     void  setAzim01SanityCheck(float p_fAzim01);
     void  setElev01SanityCheck(float p_fElev01);
     //old position parameters, for calculating deltas
@@ -129,11 +133,11 @@ private:
     float m_fPrevAzim01;
     float m_fPrevElev01;
     
-    ElevationStatus  m_iElevationStatus;
-    float   m_fElevOverflow;
-    bool    m_bElevationWasMaxed;
-    
-    void setXYUsingAzimElev01(float azim01, float elev01);
+    ZirkVector3 m_oGroupVector;
+    //! azimuth and elevation that m_oGroupVector was projected to
+    float   m_fGroupAzim01;
+    float   m_fGroupElev01;
+    bool    m_bGroupVectorValid;
 };
 
 
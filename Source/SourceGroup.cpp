@@ -0,0 +1,95 @@
+/*
+ ==============================================================================
+ ZirkOSC: VST and AU audio plug-in enabling spatial movement of sound sources in a dome of speakers.
+
+ Copyright (C) 2015  GRIS-UdeM
+
+ Developers: Ludovic Laffineur, Vincent Berthiaume
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ==============================================================================
+ */
+
+#include "SourceGroup.h"
+
+void SourceGroup::gather(SoundSource *p_pSources, int p_iNbrSources, int p_iSkippedSource, Space p_eSpace){
+    jassert(p_iNbrSources <= s_kiMaxSources);
+    m_eSpace = p_eSpace;
+    m_iCount = 0;
+    for (int iCurSource = 0; iCurSource < p_iNbrSources; ++iCurSource){
+        if (iCurSource == p_iSkippedSource){
+            continue;
+        }
+        SoundSource &oSource = p_pSources[iCurSource];
+        switch (m_eSpace){
+            case DomeVectors: {
+                ZirkVector3 oVector = oSource.getGroupVector();
+                m_fCoordinates[0][m_iCount] = oVector.x;
+                m_fCoordinates[1][m_iCount] = oVector.y;
+                m_fCoordinates[2][m_iCount] = oVector.z;
+                break;
+            }
+            case XY01:
+                m_fCoordinates[0][m_iCount] = oSource.getX01();
+                m_fCoordinates[1][m_iCount] = oSource.getY01();
+                break;
+            case AzimElev01:
+                m_fCoordinates[0][m_iCount] = oSource.getAzimuth01();
+                m_fCoordinates[1][m_iCount] = oSource.getElevation01();
+                break;
+        }
+        m_iSources[m_iCount++] = iCurSource;
+    }
+}
+
+void SourceGroup::select(int p_iNbrSources, Space p_eSpace){
+    jassert(p_iNbrSources <= s_kiMaxSources);
+    m_eSpace = p_eSpace;
+    m_iCount = p_iNbrSources;
+    for (int iCurSource = 0; iCurSource < p_iNbrSources; ++iCurSource){
+        m_iSources[iCurSource] = iCurSource;
+    }
+}
+
+void SourceGroup::scatter(SoundSource *p_pSources){
+    float *pA = m_fCoordinates[0], *pB = m_fCoordinates[1], *pC = m_fCoordinates[2];
+    switch (m_eSpace){
+        case DomeVectors:
+            for (int i = 0; i < m_iCount; ++i){
+                SoundSource::vectorToPosition01({pA[i], pB[i], pC[i]}, m_fX01[i], m_fY01[i], m_fAzim01[i], m_fElev01[i]);
+            }
+            for (int i = 0; i < m_iCount; ++i){
+                p_pSources[m_iSources[i]].setGroupPosition({pA[i], pB[i], pC[i]}, m_fX01[i], m_fY01[i], m_fAzim01[i], m_fElev01[i]);
+            }
+            return;
+        case XY01:
+            for (int i = 0; i < m_iCount; ++i){
+                SoundSource::XY01toAzimElev01(pA[i], pB[i], m_fAzim01[i], m_fElev01[i]);
+            }
+            for (int i = 0; i < m_iCount; ++i){
+                p_pSources[m_iSources[i]].setXYAzimElev01(pA[i], pB[i], m_fAzim01[i], m_fElev01[i]);
+                p_pSources[m_iSources[i]].setPrevLoc01(pA[i], pB[i], m_fAzim01[i], m_fElev01[i]);
+            }
+            return;
+        case AzimElev01:
+            for (int i = 0; i < m_iCount; ++i){
+                SoundSource::azimElev01toXY01(pA[i], pB[i], m_fX01[i], m_fY01[i]);
+            }
+            for (int i = 0; i < m_iCount; ++i){
+                p_pSources[m_iSources[i]].setXYAzimElev01(m_fX01[i], m_fY01[i], pA[i], pB[i]);
+                p_pSources[m_iSources[i]].setPrevLoc01(m_fX01[i], m_fY01[i], pA[i], pB[i]);
+            }
+            return;
+    }
+}
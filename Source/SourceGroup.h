@@ -0,0 +1,85 @@
+/*
+ ==============================================================================
+ ZirkOSC: VST and AU audio plug-in enabling spatial movement of sound sources in a dome of speakers.
+
+ Copyright (C) 2015  GRIS-UdeM
+
+ Developers: Ludovic Laffineur, Vincent Berthiaume
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ==============================================================================
+ */
+
+
+#ifndef __ZirkOSCJUCE__SourceGroup__
+#define __ZirkOSCJUCE__SourceGroup__
+
+#include "SoundSource.h"
+#include "Tools.h"
+
+//! Sources moved together by a constraint, copied into contiguous arrays. A solve is gather(), then one or more passes over
+//! the arrays, then scatter(), which converts all positions in one loop and writes each source back once, with its xy,
+//! azimuth and elevation already consistent so nothing is converted again when they are read.
+class SourceGroup {
+public:
+    static const int s_kiMaxSources = 64;
+    
+    //! what the coordinate arrays hold between gather() and scatter()
+    enum Space {
+        DomeVectors,    //!< group vectors: x, y, z
+        XY01,           //!< x01, y01
+        AzimElev01      //!< azimuth01, elevation01
+    };
+    
+    SourceGroup()
+    :m_iCount(0)
+    ,m_eSpace(DomeVectors)
+    {}
+    
+    //! copy the positions of the first p_iNbrSources sources, except p_iSkippedSource (-1 to keep them all), in p_eSpace
+    void gather(SoundSource *p_pSources, int p_iNbrSources, int p_iSkippedSource, Space p_eSpace = DomeVectors);
+    //! take the first p_iNbrSources sources without reading their positions, for passes that overwrite all coordinates
+    void select(int p_iNbrSources, Space p_eSpace);
+    //! only for groups gathered as DomeVectors
+    void rotate(const ZirkRotation &p_oRotation){
+        jassert(m_eSpace == DomeVectors);
+        p_oRotation.apply(m_fCoordinates[0], m_fCoordinates[1], m_fCoordinates[2], m_iCount);
+    }
+    //! write the group back to the sources it was gathered from, also setting their previous location
+    void scatter(SoundSource *p_pSources);
+    int size() const {
+        return m_iCount;
+    }
+    //! index of the p_iEntry-th gathered source in the array it was gathered from
+    int getSource(int p_iEntry) const {
+        return m_iSources[p_iEntry];
+    }
+    //! one value per gathered source, for coordinate 0, 1 or 2 of the Space, in the order listed there
+    float* getCoordinates(int p_iCoordinate){
+        return m_fCoordinates[p_iCoordinate];
+    }
+    
+private:
+    int   m_iCount;
+    Space m_eSpace;
+    int   m_iSources[s_kiMaxSources];
+    float m_fCoordinates[3][s_kiMaxSources];
+    //positions computed by scatter()
+    float m_fX01[s_kiMaxSources];
+    float m_fY01[s_kiMaxSources];
+    float m_fAzim01[s_kiMaxSources];
+    float m_fElev01[s_kiMaxSources];
+};
+
+#endif /* defined(__ZirkOSCJUCE__SourceGroup__) */
@@ -0,0 +1,108 @@
+/*
+ ==============================================================================
+ ZirkOSC: VST and AU audio plug-in enabling spatial movement of sound sources in a dome of speakers.
+
+ Copyright (C) 2015  GRIS-UdeM
+
+ Developers: Ludovic Laffineur, Vincent Berthiaume
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ==============================================================================
+ */
+
+
+#include "SourceHitGrid.h"
+
+SourceHitGrid::SourceHitGrid()
+:m_iDomeRadius(-1)
+,m_fHitRadius(1)
+,m_iCellsPerSide(0)
+{
+    for (int i = 0; i < ZirkOSC_Max_Sources; ++i){
+        m_aCell[i] = m_aNext[i] = -1;
+    }
+}
+
+void SourceHitGrid::reset(int p_iDomeRadius, float p_fHitRadius){
+    m_iDomeRadius   = p_iDomeRadius;
+    m_fHitRadius    = p_fHitRadius;
+    m_iCellsPerSide = jmax(1, static_cast<int>(ceilf(2 * (p_iDomeRadius + p_fHitRadius) / p_fHitRadius)));
+    m_aCellHeads.clearQuick();
+    m_aCellHeads.insertMultiple(0, -1, m_iCellsPerSide * m_iCellsPerSide);
+    for (int i = 0; i < ZirkOSC_Max_Sources; ++i){
+        m_aCell[i] = m_aNext[i] = -1;
+    }
+}
+
+int SourceHitGrid::getCell(Point<float> p_oPosition) const {
+    const float fOrigin = m_iDomeRadius + m_fHitRadius;
+    int iColumn = jlimit(0, m_iCellsPerSide - 1, static_cast<int>((p_oPosition.x + fOrigin) / m_fHitRadius));
+    int iRow    = jlimit(0, m_iCellsPerSide - 1, static_cast<int>((p_oPosition.y + fOrigin) / m_fHitRadius));
+    return iRow * m_iCellsPerSide + iColumn;
+}
+
+void SourceHitGrid::unlink(int p_iSource){
+    int *pLink = &m_aCellHeads.getReference(m_aCell[p_iSource]);
+    while (*pLink != p_iSource){
+        pLink = &m_aNext[*pLink];
+    }
+    *pLink = m_aNext[p_iSource];
+    m_aCell[p_iSource] = m_aNext[p_iSource] = -1;
+}
+
+void SourceHitGrid::update(int p_iSource, Point<float> p_oPosition){
+    if (m_iCellsPerSide == 0){
+        return;
+    }
+    const int iCell = getCell(p_oPosition);
+    m_aPositions[p_iSource] = p_oPosition;
+    if (iCell == m_aCell[p_iSource]){
+        return;
+    }
+    if (m_aCell[p_iSource] != -1){
+        unlink(p_iSource);
+    }
+    m_aCell[p_iSource] = iCell;
+    m_aNext[p_iSource] = m_aCellHeads[iCell];
+    m_aCellHeads.set(iCell, p_iSource);
+}
+
+void SourceHitGrid::remove(int p_iSource){
+    if (m_aCell[p_iSource] != -1){
+        unlink(p_iSource);
+    }
+}
+
+int SourceHitGrid::findSource(Point<float> p_oPosition) const {
+    if (m_iCellsPerSide == 0){
+        return -1;
+    }
+    const int iCell = getCell(p_oPosition);
+    const int iRow = iCell / m_iCellsPerSide, iColumn = iCell % m_iCellsPerSide;
+    int   iFound = -1;
+    float fFoundDistance = m_fHitRadius * m_fHitRadius;
+    for (int iCurRow = jmax(0, iRow - 1); iCurRow <= jmin(m_iCellsPerSide - 1, iRow + 1); ++iCurRow){
+        for (int iCurColumn = jmax(0, iColumn - 1); iCurColumn <= jmin(m_iCellsPerSide - 1, iColumn + 1); ++iCurColumn){
+            for (int iSource = m_aCellHeads[iCurRow * m_iCellsPerSide + iCurColumn]; iSource != -1; iSource = m_aNext[iSource]){
+                const Point<float> oOffset = p_oPosition - m_aPositions[iSource];
+                const float fDistance = oOffset.x * oOffset.x + oOffset.y * oOffset.y;
+                if (fDistance < fFoundDistance || (fDistance == fFoundDistance && iSource > iFound)){
+                    iFound = iSource;
+                    fFoundDistance = fDistance;
+                }
+            }
+        }
+    }
+    return iFound;
+}
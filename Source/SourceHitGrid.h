@@ -0,0 +1,63 @@
+/*
+ ==============================================================================
+ ZirkOSC: VST and AU audio plug-in enabling spatial movement of sound sources in a dome of speakers.
+
+ Copyright (C) 2015  GRIS-UdeM
+
+ Developers: Ludovic Laffineur, Vincent Berthiaume
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ==============================================================================
+ */
+
+
+#ifndef __ZirkOSCJUCE__SourceHitGrid__
+#define __ZirkOSCJUCE__SourceHitGrid__
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "ZirkConstants.h"
+
+//! Uniform grid over the screen positions of the sources, relative to the dome center, in pixels. Cells are as large as the
+//! hit radius, so a query only looks at the 3x3 cells around the point. Sources are moved between cells as they move, and
+//! the query returns the nearest source within the radius, the topmost one (highest index, painted last) on ties.
+class SourceHitGrid {
+public:
+    SourceHitGrid();
+    
+    //! drop all sources and cover a dome of radius p_iDomeRadius, plus p_fHitRadius around it
+    void reset(int p_iDomeRadius, float p_fHitRadius);
+    int getDomeRadius() const {
+        return m_iDomeRadius;
+    }
+    //! place source p_iSource at p_oPosition, or leave it where it is if it did not move
+    void update(int p_iSource, Point<float> p_oPosition);
+    void remove(int p_iSource);
+    //! nearest source within the hit radius of p_oPosition, or -1
+    int findSource(Point<float> p_oPosition) const;
+    
+private:
+    int getCell(Point<float> p_oPosition) const;
+    void unlink(int p_iSource);
+    
+    int   m_iDomeRadius;
+    float m_fHitRadius;
+    int   m_iCellsPerSide;
+    //! first source of each cell, and the next source in the same cell for each source; -1 ends the list
+    Array<int> m_aCellHeads;
+    int m_aNext[ZirkOSC_Max_Sources];
+    int m_aCell[ZirkOSC_Max_Sources];
+    Point<float> m_aPositions[ZirkOSC_Max_Sources];
+};
+
+#endif /* defined(__ZirkOSCJUCE__SourceHitGrid__) */
@@ -0,0 +1,112 @@
+/*
+ ==============================================================================
+ ZirkOSC: VST and AU audio plug-in enabling spatial movement of sound sources in a dome of speakers.
+
+ Copyright (C) 2015  GRIS-UdeM
+
+ Developers: Ludovic Laffineur, Vincent Berthiaume
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ==============================================================================
+ */
+
+
+#include "SourceList.h"
+#include "PluginProcessor.h"
+
+SourceListTab::SourceListTab(ZirkOscAudioProcessor *p_pProcessor)
+:m_pProcessor(p_pProcessor)
+,m_oTable("Sources", this)
+,m_iNbrRows(0)
+{
+    TableHeaderComponent &oHeader = m_oTable.getHeader();
+    oHeader.addColumn("Source",     Id,             60);
+    oHeader.addColumn("Azimuth",    Azimuth,        70);
+    oHeader.addColumn("Elevation",  Elevation,      70);
+    oHeader.addColumn("Azim span",  AzimuthSpan,    70);
+    oHeader.addColumn("Elev span",  ElevationSpan,  70);
+    oHeader.addColumn("Gain",       Gain,           60);
+    m_oTable.setRowHeight(18);
+    addAndMakeVisible(&m_oTable);
+    SourceSet oAllSources;
+    oAllSources.setAll();
+    refresh(oAllSources);
+}
+
+void SourceListTab::resized(){
+    m_oTable.setBounds(getLocalBounds());
+}
+
+void SourceListTab::updateRow(int p_iSource){
+    if (!m_oStaleRows.contains(p_iSource)){
+        return;
+    }
+    m_oStaleRows.reset(p_iSource);
+    SoundSource &oSource = m_pProcessor->getSources()[p_iSource];
+    String *pCells = m_aCells[p_iSource];
+    pCells[Id - 1]              = String(oSource.getSourceId());
+    pCells[Azimuth - 1]         = String(PercentToHR(oSource.getAzimuth01(),     ZirkOSC_Azim_Min,     ZirkOSC_Azim_Max), 1);
+    pCells[Elevation - 1]       = String(PercentToHR(oSource.getElevation01(),   ZirkOSC_Elev_Min,     ZirkOSC_Elev_Max), 1);
+    pCells[AzimuthSpan - 1]     = String(PercentToHR(oSource.getAzimuthSpan(),   ZirkOSC_AzimSpan_Min, ZirkOSC_AzimSpan_Max), 1);
+    pCells[ElevationSpan - 1]   = String(PercentToHR(oSource.getElevationSpan(), ZirkOSC_ElevSpan_Min, ZirkOSC_ElevSpan_Max), 1);
+    pCells[Gain - 1]            = String(oSource.getGain01(), 2);
+}
+
+void SourceListTab::refresh(const SourceSet &p_oChangedSources){
+    const int iNbrSources = m_pProcessor->getNbrSources();
+    if (iNbrSources != m_iNbrRows){
+        m_iNbrRows = iNbrSources;
+        m_oTable.updateContent();
+    }
+    if (!p_oChangedSources.isEmpty()){
+        for (int iCurSource = 0; iCurSource < iNbrSources; ++iCurSource){
+            if (p_oChangedSources.contains(iCurSource)){
+                m_oStaleRows.set(iCurSource);
+                //only reaches paintCell if the row is on screen
+                m_oTable.repaintRow(iCurSource);
+            }
+        }
+    }
+    const int iSelected = m_pProcessor->getSelectedSource();
+    if (m_oTable.getSelectedRow() != iSelected && iSelected < iNbrSources){
+        m_oTable.selectRow(iSelected);
+    }
+}
+
+int SourceListTab::getNumRows(){
+    return m_iNbrRows;
+}
+
+void SourceListTab::paintRowBackground (Graphics &g, int p_iRow, int, int, bool p_bSelected){
+    if (p_bSelected){
+        g.fillAll(Colours::lightblue);
+    } else if (p_iRow % 2){
+        g.fillAll(Colour(0xffeeeeee));
+    }
+}
+
+void SourceListTab::paintCell (Graphics &g, int p_iRow, int p_iColumn, int p_iWidth, int p_iHeight, bool){
+    if (p_iRow >= m_iNbrRows){
+        return;
+    }
+    updateRow(p_iRow);
+    g.setColour(Colours::black);
+    g.drawText(m_aCells[p_iRow][p_iColumn - 1], 2, 0, p_iWidth - 4, p_iHeight, Justification::centredLeft, true);
+}
+
+void SourceListTab::selectedRowsChanged (int p_iLastRow){
+    if (p_iLastRow >= 0 && p_iLastRow != m_pProcessor->getSelectedSource()){
+        m_pProcessor->setSelectedSource(p_iLastRow);
+    }
+}
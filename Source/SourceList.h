@@ -0,0 +1,69 @@
+/*
+ ==============================================================================
+ ZirkOSC: VST and AU audio plug-in enabling spatial movement of sound sources in a dome of speakers.
+
+ Copyright (C) 2015  GRIS-UdeM
+
+ Developers: Ludovic Laffineur, Vincent Berthiaume
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ==============================================================================
+ */
+
+
+#ifndef __ZirkOSCJUCE__SourceList__
+#define __ZirkOSCJUCE__SourceList__
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "ZirkConstants.h"
+#include "SourceSet.h"
+
+class ZirkOscAudioProcessor;
+
+//! Table of all sources: id, azimuth, elevation, spans and gain. The TableListBox only paints the rows that are visible.
+//! When the processor flags a source as changed, its row is only marked stale, and its text is formatted again when the
+//! row is next painted, so neither sources that do not move nor rows scrolled out of view cost anything to display.
+//! Clicking a row selects its source.
+class SourceListTab : public Component, private TableListBoxModel {
+public:
+    SourceListTab(ZirkOscAudioProcessor *p_pProcessor);
+    
+    //! mark the rows of p_oChangedSources stale and repaint them if they are visible, and follow the selected source
+    void refresh(const SourceSet &p_oChangedSources);
+    
+    void resized() override;
+    
+private:
+    enum Columns {Id = 1, Azimuth, Elevation, AzimuthSpan, ElevationSpan, Gain, NbrColumns = Gain};
+    
+    int getNumRows() override;
+    void paintRowBackground (Graphics &g, int p_iRow, int p_iWidth, int p_iHeight, bool p_bSelected) override;
+    void paintCell (Graphics &g, int p_iRow, int p_iColumn, int p_iWidth, int p_iHeight, bool p_bSelected) override;
+    void selectedRowsChanged (int p_iLastRow) override;
+    
+    //! format the text of row p_iSource if it is stale
+    void updateRow(int p_iSource);
+    
+    ZirkOscAudioProcessor *m_pProcessor;
+    TableListBox m_oTable;
+    int m_iNbrRows;
+    //! text shown in each cell, formatted when the source changes
+    String m_aCells[ZirkOSC_Max_Sources][NbrColumns];
+    //! rows whose source changed since their text was formatted
+    SourceSet m_oStaleRows;
+    
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SourceListTab)
+};
+
+#endif /* defined(__ZirkOSCJUCE__SourceList__) */
@@ -0,0 +1,100 @@
+/*
+ ==============================================================================
+ ZirkOSC: VST and AU audio plug-in enabling spatial movement of sound sources in a dome of speakers.
+
+ Copyright (C) 2015  GRIS-UdeM
+
+ Developers: Ludovic Laffineur, Vincent Berthiaume
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ==============================================================================
+ */
+
+
+#ifndef __ZirkOSCJUCE__SourceSet__
+#define __ZirkOSCJUCE__SourceSet__
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "ZirkConstants.h"
+
+//! Set of source indices, one bit per source, sized for ZirkOSC_Max_Sources.
+class SourceSet {
+public:
+    SourceSet(){
+        clear();
+    }
+    void clear(){
+        for (int iWord = 0; iWord < s_kiWords; ++iWord){
+            m_aWords[iWord] = 0;
+        }
+    }
+    void setAll(){
+        for (int iWord = 0; iWord < s_kiWords; ++iWord){
+            m_aWords[iWord] = ~0u;
+        }
+    }
+    void set(int p_iSource){
+        m_aWords[p_iSource >> 5] |= 1u << (p_iSource & 31);
+    }
+    void reset(int p_iSource){
+        m_aWords[p_iSource >> 5] &= ~(1u << (p_iSource & 31));
+    }
+    bool contains(int p_iSource) const {
+        return (m_aWords[p_iSource >> 5] & (1u << (p_iSource & 31))) != 0;
+    }
+    bool isEmpty() const {
+        for (int iWord = 0; iWord < s_kiWords; ++iWord){
+            if (m_aWords[iWord] != 0){
+                return false;
+            }
+        }
+        return true;
+    }
+    
+private:
+    friend class AtomicSourceSet;
+    static const int s_kiWords = (ZirkOSC_Max_Sources + 31) / 32;
+    uint32 m_aWords[s_kiWords];
+};
+
+//! SourceSet that any thread can add to without locking, and one reader takes as a whole, clearing it.
+class AtomicSourceSet {
+public:
+    void set(int p_iSource){
+        Atomic<uint32> &oWord = m_aWords[p_iSource >> 5];
+        const uint32 iBit = 1u << (p_iSource & 31);
+        uint32 iWord;
+        do {
+            iWord = oWord.get();
+        } while ((iWord & iBit) == 0 && !oWord.compareAndSetBool(iWord | iBit, iWord));
+    }
+    void setAll(){
+        for (int iWord = 0; iWord < SourceSet::s_kiWords; ++iWord){
+            m_aWords[iWord] = ~0u;
+        }
+    }
+    //! what was set since the last call. A set() racing with take() lands in this result or the next one, never in neither
+    SourceSet take(){
+        SourceSet oSet;
+        for (int iWord = 0; iWord < SourceSet::s_kiWords; ++iWord){
+            oSet.m_aWords[iWord] = m_aWords[iWord].exchange(0);
+        }
+        return oSet;
+    }
+    
+private:
+    Atomic<uint32> m_aWords[SourceSet::s_kiWords];
+};
+
+#endif /* defined(__ZirkOSCJUCE__SourceSet__) */
@@ -0,0 +1,170 @@
+/*
+ ==============================================================================
+ ZirkOSC: VST and AU audio plug-in enabling spatial movement of sound sources in a dome of speakers.
+
+ Copyright (C) 2015  GRIS-UdeM
+
+ Developers: Ludovic Laffineur, Vincent Berthiaume
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ==============================================================================
+ */
+
+
+#include "SourceSnapshots.h"
+
+int SourceSnapshots::indexOf(const String &p_sName) const {
+    for (int iSnapshot = 0; iSnapshot < m_iCount; ++iSnapshot){
+        if (m_oSnapshots[iSnapshot].m_sName == p_sName){
+            return iSnapshot;
+        }
+    }
+    return -1;
+}
+
+bool SourceSnapshots::capture(const String &p_sName, SoundSource *p_pSources){
+    const ScopedLock oLock(m_oLock);
+    int iSnapshot = indexOf(p_sName);
+    if (iSnapshot == -1){
+        if (m_iCount == s_kiMaxSnapshots){
+            return false;
+        }
+        iSnapshot = m_iCount++;
+    }
+    SourceSnapshot &oSnapshot = m_oSnapshots[iSnapshot];
+    oSnapshot.m_sName = p_sName;
+    //sources that are not in use are stored too, so they are where they were if the number of sources grows again
+    for (int iCurSrc = 0; iCurSrc < ZirkOSC_Max_Sources; ++iCurSrc){
+        oSnapshot.m_fAzim01[iCurSrc]    = p_pSources[iCurSrc].getAzimuth01();
+        oSnapshot.m_fElev01[iCurSrc]    = p_pSources[iCurSrc].getElevation01();
+        oSnapshot.m_fAzimSpan[iCurSrc]  = p_pSources[iCurSrc].getAzimuthSpan();
+        oSnapshot.m_fElevSpan[iCurSrc]  = p_pSources[iCurSrc].getElevationSpan();
+        oSnapshot.m_fGain[iCurSrc]      = p_pSources[iCurSrc].getGain01();
+    }
+    updateVectors(oSnapshot);
+    return true;
+}
+
+void SourceSnapshots::remove(int p_iSnapshot){
+    const ScopedLock oLock(m_oLock);
+    if (p_iSnapshot < 0 || p_iSnapshot >= m_iCount){
+        return;
+    }
+    for (int iSnapshot = p_iSnapshot; iSnapshot < m_iCount-1; ++iSnapshot){
+        m_oSnapshots[iSnapshot] = m_oSnapshots[iSnapshot+1];
+    }
+    --m_iCount;
+}
+
+bool SourceSnapshots::recall(int p_iSnapshot, SoundSource *p_pSources, int p_iNbrSources, SourceGroup &p_oGroup){
+    const ScopedLock oLock(m_oLock);
+    if (p_iSnapshot < 0 || p_iSnapshot >= m_iCount){
+        return false;
+    }
+    interpolate(p_iSnapshot, p_iSnapshot, 0, p_pSources, p_iNbrSources, p_oGroup);
+    return true;
+}
+
+bool SourceSnapshots::morph(float p_fMorph01, SoundSource *p_pSources, int p_iNbrSources, SourceGroup &p_oGroup){
+    const ScopedTryLock oLock(m_oLock);
+    if (!oLock.isLocked() || m_iCount < 2){
+        return false;
+    }
+    float fPosition = jlimit(0.f, 1.f, p_fMorph01) * (m_iCount - 1);
+    int   iFrom     = jmin(static_cast<int>(fPosition), m_iCount - 2);
+    interpolate(iFrom, iFrom + 1, fPosition - iFrom, p_pSources, p_iNbrSources, p_oGroup);
+    return true;
+}
+
+void SourceSnapshots::interpolate(int p_iFrom, int p_iTo, float p_fProgress01, SoundSource *p_pSources, int p_iNbrSources, SourceGroup &p_oGroup){
+    const SourceSnapshot &oFrom = m_oSnapshots[p_iFrom];
+    const SourceSnapshot &oTo   = m_oSnapshots[p_iTo];
+    const float t = p_fProgress01;
+    
+    p_oGroup.select(p_iNbrSources, SourceGroup::DomeVectors);
+    float *pX = p_oGroup.getCoordinates(0), *pY = p_oGroup.getCoordinates(1), *pZ = p_oGroup.getCoordinates(2);
+    for (int i = 0; i < p_iNbrSources; ++i){
+        float fDot   = jlimit(-1.f, 1.f, oFrom.m_fX[i] * oTo.m_fX[i] + oFrom.m_fY[i] * oTo.m_fY[i] + oFrom.m_fZ[i] * oTo.m_fZ[i]);
+        float fAngle = ZirkMath::acos(fDot);
+        float fSin   = ZirkMath::sin(fAngle);
+        float fFromWeight, fToWeight, fZenithWeight = 0;
+        if (fSin > 1e-4f){
+            fFromWeight = ZirkMath::sin((1 - t) * fAngle) / fSin;
+            fToWeight   = ZirkMath::sin(t * fAngle) / fSin;
+        } else if (fDot > 0){
+            //same point, or close enough for a straight line
+            fFromWeight = 1 - t;
+            fToWeight   = t;
+        } else {
+            //opposite points on the horizon: every great circle joins them, take the one over the zenith
+            fFromWeight   = ZirkMath::cos(t * ZirkMath::kPi);
+            fToWeight     = 0;
+            fZenithWeight = ZirkMath::sin(t * ZirkMath::kPi);
+        }
+        pX[i] = fFromWeight * oFrom.m_fX[i] + fToWeight * oTo.m_fX[i];
+        pY[i] = fFromWeight * oFrom.m_fY[i] + fToWeight * oTo.m_fY[i];
+        pZ[i] = fFromWeight * oFrom.m_fZ[i] + fToWeight * oTo.m_fZ[i] + fZenithWeight;
+    }
+    p_oGroup.scatter(p_pSources);
+    
+    for (int i = 0; i < p_iNbrSources; ++i){
+        p_pSources[i].setAzimuthSpan  (oFrom.m_fAzimSpan[i] + t * (oTo.m_fAzimSpan[i] - oFrom.m_fAzimSpan[i]));
+        p_pSources[i].setElevationSpan(oFrom.m_fElevSpan[i] + t * (oTo.m_fElevSpan[i] - oFrom.m_fElevSpan[i]));
+        p_pSources[i].setGain01       (oFrom.m_fGain[i]     + t * (oTo.m_fGain[i]     - oFrom.m_fGain[i]));
+    }
+}
+
+void SourceSnapshots::updateVectors(SourceSnapshot &p_oSnapshot){
+    for (int iCurSrc = 0; iCurSrc < ZirkOSC_Max_Sources; ++iCurSrc){
+        ZirkVector3 oVector = SoundSource::azimElev01toVector(p_oSnapshot.m_fAzim01[iCurSrc], p_oSnapshot.m_fElev01[iCurSrc]);
+        p_oSnapshot.m_fX[iCurSrc] = oVector.x;
+        p_oSnapshot.m_fY[iCurSrc] = oVector.y;
+        p_oSnapshot.m_fZ[iCurSrc] = oVector.z;
+    }
+}
+
+void SourceSnapshots::toXml(XmlElement &p_oParent) const {
+    for (int iSnapshot = 0; iSnapshot < m_iCount; ++iSnapshot){
+        const SourceSnapshot &oSnapshot = m_oSnapshots[iSnapshot];
+        XmlElement *pSnapshot = p_oParent.createNewChildElement("Snapshot");
+        pSnapshot->setAttribute("name", oSnapshot.m_sName);
+        for (int iCurSrc = 0; iCurSrc < ZirkOSC_Max_Sources; ++iCurSrc){
+            pSnapshot->setAttribute("Azim01"        + String(iCurSrc), oSnapshot.m_fAzim01[iCurSrc]);
+            pSnapshot->setAttribute("Elev01"        + String(iCurSrc), oSnapshot.m_fElev01[iCurSrc]);
+            pSnapshot->setAttribute("AzimuthSpan"   + String(iCurSrc), oSnapshot.m_fAzimSpan[iCurSrc]);
+            pSnapshot->setAttribute("ElevationSpan" + String(iCurSrc), oSnapshot.m_fElevSpan[iCurSrc]);
+            pSnapshot->setAttribute("Gain"          + String(iCurSrc), oSnapshot.m_fGain[iCurSrc]);
+        }
+    }
+}
+
+void SourceSnapshots::fromXml(const XmlElement &p_oParent){
+    const ScopedLock oLock(m_oLock);
+    m_iCount = 0;
+    forEachXmlChildElementWithTagName(p_oParent, pSnapshot, "Snapshot"){
+        if (m_iCount == s_kiMaxSnapshots){
+            break;
+        }
+        SourceSnapshot &oSnapshot = m_oSnapshots[m_iCount++];
+        oSnapshot.m_sName = pSnapshot->getStringAttribute("name");
+        for (int iCurSrc = 0; iCurSrc < ZirkOSC_Max_Sources; ++iCurSrc){
+            oSnapshot.m_fAzim01[iCurSrc]    = static_cast<float>(pSnapshot->getDoubleAttribute("Azim01"        + String(iCurSrc), 0));
+            oSnapshot.m_fElev01[iCurSrc]    = static_cast<float>(pSnapshot->getDoubleAttribute("Elev01"        + String(iCurSrc), 0));
+            oSnapshot.m_fAzimSpan[iCurSrc]  = static_cast<float>(pSnapshot->getDoubleAttribute("AzimuthSpan"   + String(iCurSrc), 0));
+            oSnapshot.m_fElevSpan[iCurSrc]  = static_cast<float>(pSnapshot->getDoubleAttribute("ElevationSpan" + String(iCurSrc), 0));
+            oSnapshot.m_fGain[iCurSrc]      = static_cast<float>(pSnapshot->getDoubleAttribute("Gain"          + String(iCurSrc), 1));
+        }
+        updateVectors(oSnapshot);
+    }
+}
@@ -0,0 +1,89 @@
+/*
+ ==============================================================================
+ ZirkOSC: VST and AU audio plug-in enabling spatial movement of sound sources in a dome of speakers.
+
+ Copyright (C) 2015  GRIS-UdeM
+
+ Developers: Ludovic Laffineur, Vincent Berthiaume
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ==============================================================================
+ */
+
+
+#ifndef __ZirkOSCJUCE__SourceSnapshots__
+#define __ZirkOSCJUCE__SourceSnapshots__
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "SoundSource.h"
+#include "SourceGroup.h"
+
+//! Position, spans and gain of all sources, stored one array per value so a morph can run over all sources at once
+struct SourceSnapshot {
+    String  m_sName;
+    float   m_fAzim01   [ZirkOSC_Max_Sources];
+    float   m_fElev01   [ZirkOSC_Max_Sources];
+    float   m_fAzimSpan [ZirkOSC_Max_Sources];
+    float   m_fElevSpan [ZirkOSC_Max_Sources];
+    float   m_fGain     [ZirkOSC_Max_Sources];
+    //! position as a unit vector, derived from azimuth and elevation
+    float   m_fX        [ZirkOSC_Max_Sources];
+    float   m_fY        [ZirkOSC_Max_Sources];
+    float   m_fZ        [ZirkOSC_Max_Sources];
+};
+
+//! Named snapshots of all sources, and the morph between them. With n snapshots, morph 0 is the first one, 1 the last one
+//! and each snapshot is reached at k/(n-1) in between. Positions travel along great circles of the dome, spans and gain
+//! are interpolated linearly. Snapshots are edited on the message thread and morphed on the audio thread, which never
+//! waits: morph() returns false when an edit is in progress, to be retried on the next block.
+class SourceSnapshots {
+public:
+    static const int s_kiMaxSnapshots = 16;
+    
+    SourceSnapshots()
+    :m_iCount(0)
+    {}
+    
+    int size() const {
+        return m_iCount;
+    }
+    String getName(int p_iSnapshot) const {
+        return m_oSnapshots[p_iSnapshot].m_sName;
+    }
+    //! index of the snapshot with that name, or -1
+    int indexOf(const String &p_sName) const;
+    //! store all ZirkOSC_Max_Sources sources as p_sName, replacing the snapshot with that name if there is one.
+    //! Returns false if p_sName is new and there are already s_kiMaxSnapshots snapshots
+    bool capture(const String &p_sName, SoundSource *p_pSources);
+    void remove(int p_iSnapshot);
+    
+    //! move the first p_iNbrSources sources to snapshot p_iSnapshot
+    bool recall(int p_iSnapshot, SoundSource *p_pSources, int p_iNbrSources, SourceGroup &p_oGroup);
+    //! move the first p_iNbrSources sources to p_fMorph01 along the snapshots. Returns false if there are fewer than 2 of them
+    bool morph(float p_fMorph01, SoundSource *p_pSources, int p_iNbrSources, SourceGroup &p_oGroup);
+    
+    void toXml(XmlElement &p_oParent) const;
+    void fromXml(const XmlElement &p_oParent);
+    
+private:
+    //! move the sources to p_fProgress01 between snapshots p_iFrom and p_iTo
+    void interpolate(int p_iFrom, int p_iTo, float p_fProgress01, SoundSource *p_pSources, int p_iNbrSources, SourceGroup &p_oGroup);
+    static void updateVectors(SourceSnapshot &p_oSnapshot);
+    
+    SourceSnapshot  m_oSnapshots[s_kiMaxSnapshots];
+    int             m_iCount;
+    CriticalSection m_oLock;
+};
+
+#endif /* defined(__ZirkOSCJUCE__SourceSnapshots__) */
@@ -22,3 +22,72 @@
  */
 
 #include "Tools.h"
+
+constexpr float ZirkMath::kPi;
+constexpr float ZirkMath::kHalfPi;
+constexpr float ZirkMath::kTwoPi;
+constexpr float ZirkMath::kDegreeToRadian;
+
+ZirkRotation::ZirkRotation(){
+    for (int i = 0; i < 3; ++i){
+        for (int j = 0; j < 3; ++j){
+            m[i][j] = (i == j) ? 1.f : 0.f;
+        }
+    }
+}
+
+ZirkRotation ZirkRotation::aboutAxis(const ZirkVector3 &a, float p_fAngle){
+    //Rodrigues' formula
+    const float c = ZirkMath::cos(p_fAngle), s = ZirkMath::sin(p_fAngle), t = 1 - c;
+    ZirkRotation r;
+    r.m[0][0] = t*a.x*a.x + c;      r.m[0][1] = t*a.x*a.y - s*a.z;  r.m[0][2] = t*a.x*a.z + s*a.y;
+    r.m[1][0] = t*a.x*a.y + s*a.z;  r.m[1][1] = t*a.y*a.y + c;      r.m[1][2] = t*a.y*a.z - s*a.x;
+    r.m[2][0] = t*a.x*a.z - s*a.y;  r.m[2][1] = t*a.y*a.z + s*a.x;  r.m[2][2] = t*a.z*a.z + c;
+    return r;
+}
+
+ZirkRotation ZirkRotation::operator* (const ZirkRotation &p_oFirst) const {
+    ZirkRotation r;
+    for (int i = 0; i < 3; ++i){
+        for (int j = 0; j < 3; ++j){
+            r.m[i][j] = m[i][0] * p_oFirst.m[0][j] + m[i][1] * p_oFirst.m[1][j] + m[i][2] * p_oFirst.m[2][j];
+        }
+    }
+    return r;
+}
+
+void ZirkRotation::apply(float *p_pX, float *p_pY, float *p_pZ, int p_iCount) const {
+    for (int i = 0; i < p_iCount; ++i){
+        const float x = p_pX[i], y = p_pY[i], z = p_pZ[i];
+        p_pX[i] = m[0][0]*x + m[0][1]*y + m[0][2]*z;
+        p_pY[i] = m[1][0]*x + m[1][1]*y + m[1][2]*z;
+        p_pZ[i] = m[2][0]*x + m[2][1]*y + m[2][2]*z;
+    }
+}
+
+float ZirkNoise::gradientNoise(uint32_t p_iSeed, double t){
+    double dCell = floor(t);
+    float  f     = static_cast<float>(t - dCell);
+    uint32_t i   = static_cast<uint32_t>(static_cast<int64_t>(dCell));
+    float g0 = 2 * ZirkRandom::hashFloat01(p_iSeed, i)   - 1;
+    float g1 = 2 * ZirkRandom::hashFloat01(p_iSeed, i+1) - 1;
+    //quintic fade between the two ramps
+    float fFade = f * f * f * (f * (f * 6 - 15) + 10);
+    float v0 = g0 * f;
+    float v1 = g1 * (f - 1);
+    //the ramps cross at most .5 apart, so scale back to [-1,1]
+    return 2 * (v0 + fFade * (v1 - v0));
+}
+
+float ZirkNoise::fractalNoise(uint32_t p_iSeed, double t, float p_fRoughness, int p_iOctaves){
+    float fSum = 0, fNorm = 0, fAmp = 1;
+    double dFreq = 1;
+    for (int iOctave = 0; iOctave < p_iOctaves; ++iOctave){
+        const double dOffset = ZirkRandom::hashFloat01(p_iSeed, iOctave);
+        fSum  += fAmp * gradientNoise(ZirkRandom::mix(p_iSeed + iOctave), t * dFreq + dOffset);
+        fNorm += fAmp;
+        fAmp  *= p_fRoughness;
+        dFreq *= 2;
+    }
+    return fSum / fNorm;
+}
@@ -25,5 +25,174 @@
 #define __ZirkOSCJUCE__Tools__
 
 #include <iostream>
+#include <cstdint>
+#include <cmath>
+
+//! Seeded random values without state: the value for (seed, index) does not depend on any previous draw, so any step can
+//! be computed directly, and a given seed always produces the same values on every platform.
+class ZirkRandom {
+public:
+    //! uniform float in [0,1) for (seed, index). Loops filling many sources or steps have no dependency chain and can be vectorized
+    static float hashFloat01(uint32_t p_iSeed, uint32_t p_iIndex){
+        return toFloat01(mix(p_iSeed ^ (p_iIndex * 0x9E3779B9u)));
+    }
+    
+    //! splitmix32 finalizer
+    static uint32_t mix(uint32_t z){
+        z = (z ^ (z >> 16)) * 0x85EBCA6Bu;
+        z = (z ^ (z >> 13)) * 0xC2B2AE35u;
+        return z ^ (z >> 16);
+    }
+    
+private:
+    //! keep the top 24 bits, which is all the precision a float mantissa has
+    static float toFloat01(uint32_t x){
+        return (x >> 8) * (1.f / 16777216.f);
+    }
+};
+
+//! Seeded 1D noise, evaluated in closed form so that any time can be computed directly without stepping through the previous ones
+class ZirkNoise {
+public:
+    //! gradient noise in [-1,1]. It is 0 at every integer t and has continuous first and second derivatives
+    static float gradientNoise(uint32_t p_iSeed, double t);
+    //! sum of p_iOctaves octaves of gradientNoise, normalized to [-1,1]. p_fRoughness is the amplitude ratio from one octave to the next:
+    //! 0 gives a single smooth octave, 1 gives equal weight to every octave. Each octave is shifted by a seeded fraction of a cell,
+    //! otherwise they would all be 0 at the same integer t and so would the sum
+    static float fractalNoise(uint32_t p_iSeed, double t, float p_fRoughness, int p_iOctaves = 4);
+};
+
+//! Set ZIRK_USE_FAST_MATH=0 in the build settings to route ZirkMath::sin/cos/atan2/acos back to libm, eg to check
+//! that a behaviour is not caused by the approximations.
+#ifndef ZIRK_USE_FAST_MATH
+ #define ZIRK_USE_FAST_MATH 1
+#endif
+
+//! Polynomial approximations of the trigonometric functions used by the azimuth/elevation <-> xy conversions.
+//! Everything stays in float and in radians. Max absolute errors, measured against the double precision libm
+//! functions over their whole domain:
+//!     fastSin, fastCos    2e-7 for |x| < 100
+//!     fastAtan2           2e-6 rad
+//!     fastAcos            5e-7 rad
+//! which is several orders of magnitude below the .001 (in [0,1] units) error it takes to see any oscillation.
+class ZirkMath {
+public:
+    static constexpr float kPi              = 3.14159265358979f;
+    static constexpr float kHalfPi          = 1.57079632679490f;
+    static constexpr float kTwoPi           = 6.28318530717959f;
+    static constexpr float kDegreeToRadian  = 0.01745329251994f;
+    
+    static float sin(float x){
+#if ZIRK_USE_FAST_MATH
+        return fastSin(x);
+#else
+        return std::sin(x);
+#endif
+    }
+    static float cos(float x){
+#if ZIRK_USE_FAST_MATH
+        return fastCos(x);
+#else
+        return std::cos(x);
+#endif
+    }
+    static float atan2(float y, float x){
+#if ZIRK_USE_FAST_MATH
+        return fastAtan2(y, x);
+#else
+        return std::atan2(y, x);
+#endif
+    }
+    static float acos(float x){
+#if ZIRK_USE_FAST_MATH
+        return fastAcos(x);
+#else
+        return std::acos(x);
+#endif
+    }
+    
+    //! reduce x to r in [-pi/2, pi/2] with x = r + k*pi (pi split in 2 so that k*pi is exact), then an odd minimax polynomial of degree 9
+    static float fastSin(float x){
+        float k;
+        const float s = sinPolynomial(reduceByPi(x, k));
+        return (static_cast<int>(k) & 1) ? -s : s;
+    }
+    //! same reduction, then cos(r) = sin(pi/2 - |r|). Adding pi/2 to x before reducing would round x + pi/2 to a float,
+    //! an error that grows with |x|
+    static float fastCos(float x){
+        float k;
+        const float s = sinPolynomial(kHalfPi - std::fabs(reduceByPi(x, k)));
+        return (static_cast<int>(k) & 1) ? -s : s;
+    }
+    //! atan of the smaller over the larger coordinate, which is in [0,1], then unfolded to the right octant. fastAtan2(0,0) is 0
+    static float fastAtan2(float y, float x){
+        const float ax = std::fabs(x), ay = std::fabs(y);
+        const float fMax = ax > ay ? ax : ay;
+        if (fMax == 0){
+            return 0;
+        }
+        const float a = (ax > ay ? ay : ax) / fMax;
+        const float s = a * a;
+        float r = a * (.99997726f + s * (-.33262347f + s * (.19354346f + s * (-.11643287f + s * (.05265332f + s * -.01172120f)))));
+        if (ay > ax){
+            r = kHalfPi - r;
+        }
+        if (x < 0){
+            r = kPi - r;
+        }
+        return y < 0 ? -r : r;
+    }
+    //! acos(x) = sqrt(1-x) * polynomial(x) on [0,1] (Abramowitz & Stegun 4.4.46), mirrored for negative x. x is clamped to [-1,1]
+    static float fastAcos(float x){
+        float ax = std::fabs(x);
+        if (ax > 1){
+            ax = 1;
+        }
+        const float p = 1.5707963050f + ax * (-.2145988016f + ax * (.0889789874f + ax * (-.0501743046f + ax * (.0308918810f
+                      + ax * (-.0170881256f + ax * (.0066700901f + ax * -.0012624911f))))));
+        const float r = std::sqrt(1 - ax) * p;
+        return x < 0 ? kPi - r : r;
+    }
+    
+private:
+    //! r in [-pi/2, pi/2] and the integer k such that x = r + k*pi
+    static float reduceByPi(float x, float &k){
+        k = std::floor(x * (1.f / kPi) + .5f);
+        return (x - k * 3.140625f) - k * 9.67653589793e-4f;
+    }
+    //! sin(r) for r in [-pi/2, pi/2]
+    static float sinPolynomial(float r){
+        const float r2 = r * r;
+        return r + r * r2 * (-1.6666655e-1f + r2 * (8.3330251e-3f + r2 * (-1.9807414e-4f + r2 * 2.601903e-6f)));
+    }
+};
+
+//! Point on the unit sphere, z pointing to the zenith. x and y are the dome coordinates, so a point above the horizon
+//! is seen on the dome straight below it.
+struct ZirkVector3 {
+    float x, y, z;
+};
+
+//! 3x3 rotation matrix
+class ZirkRotation {
+public:
+    //! identity
+    ZirkRotation();
+    //! right-handed rotation of p_fAngle radians about p_oAxis, which has to be of unit length
+    static ZirkRotation aboutAxis(const ZirkVector3 &p_oAxis, float p_fAngle);
+    //! the rotation that applies p_oFirst, then this one
+    ZirkRotation operator* (const ZirkRotation &p_oFirst) const;
+    
+    ZirkVector3 apply(const ZirkVector3 &v) const {
+        return { m[0][0]*v.x + m[0][1]*v.y + m[0][2]*v.z,
+                 m[1][0]*v.x + m[1][1]*v.y + m[1][2]*v.z,
+                 m[2][0]*v.x + m[2][1]*v.y + m[2][2]*v.z };
+    }
+    //! rotate p_iCount vectors stored as separate x, y and z arrays, in place. Iterations are independent so the loop vectorizes
+    void apply(float *p_pX, float *p_pY, float *p_pZ, int p_iCount) const;
+    
+private:
+    float m[3][3];
+};
 
 #endif /* defined(__ZirkOSCJUCE__Tools__) */
@@ -29,11 +29,89 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 #include "ZirkConstants.h"
+#include "Tools.h"
 
 
 
 using namespace std;
 
+// ==============================================================================
+void TrajectorySpline::clear(){
+    m_aPoints.clearQuick();
+    m_aCumulativeLength.clearQuick();
+}
+
+void TrajectorySpline::addPoint(float p_fX, float p_fY){
+    Point<float> oPoint(p_fX, p_fY);
+    //about 1% of the dome diameter
+    if (m_aPoints.size() > 0 && m_aPoints.getLast().getDistanceFrom(oPoint) < .02f){
+        return;
+    }
+    m_aPoints.add(oPoint);
+}
+
+Point<float> TrajectorySpline::evaluateSegment(int p_iSegment, float t) const {
+    //uniform Catmull-Rom between points p_iSegment and p_iSegment+1, end points are duplicated
+    const int iLast = m_aPoints.size()-1;
+    const Point<float> &p0 = m_aPoints.getReference(jmax(p_iSegment-1, 0));
+    const Point<float> &p1 = m_aPoints.getReference(p_iSegment);
+    const Point<float> &p2 = m_aPoints.getReference(jmin(p_iSegment+1, iLast));
+    const Point<float> &p3 = m_aPoints.getReference(jmin(p_iSegment+2, iLast));
+    float t2 = t*t, t3 = t2*t;
+    return ((p1 * 2.f) + (p2 - p0) * t + (p0 * 2.f - p1 * 5.f + p2 * 4.f - p3) * t2 + (p1 * 3.f - p0 - p2 * 3.f + p3) * t3) * .5f;
+}
+
+void TrajectorySpline::build(){
+    m_aCumulativeLength.clearQuick();
+    if (isEmpty()){
+        return;
+    }
+    const int iSamples = (m_aPoints.size()-1) * s_kiSamplesPerSegment;
+    m_aCumulativeLength.ensureStorageAllocated(iSamples+1);
+    m_aCumulativeLength.add(0);
+    Point<float> oPrevious = m_aPoints.getFirst();
+    for (int k = 1; k <= iSamples; ++k){
+        Point<float> oCurrent = evaluateSegment((k-1) / s_kiSamplesPerSegment, static_cast<float>((k-1) % s_kiSamplesPerSegment + 1) / s_kiSamplesPerSegment);
+        m_aCumulativeLength.add(m_aCumulativeLength.getLast() + oPrevious.getDistanceFrom(oCurrent));
+        oPrevious = oCurrent;
+    }
+}
+
+Point<float> TrajectorySpline::getPointAtDistance01(float p_fDistance01) const {
+    if (m_aCumulativeLength.size() < 2 || getLength() <= 0){
+        return m_aPoints.size() == 0 ? Point<float>() : m_aPoints.getFirst();
+    }
+    const float fTarget = jlimit(0.f, 1.f, p_fDistance01) * getLength();
+    const float *pBegin = m_aCumulativeLength.begin();
+    const float *pEnd   = m_aCumulativeLength.end();
+    int k = static_cast<int>(std::lower_bound(pBegin, pEnd, fTarget) - pBegin);
+    k = jlimit(1, m_aCumulativeLength.size()-1, k);
+    //linear interpolation between the 2 table entries around fTarget
+    float fSpan = pBegin[k] - pBegin[k-1];
+    float fParam = (k-1) + (fSpan > 0 ? (fTarget - pBegin[k-1]) / fSpan : 0);
+    fParam /= s_kiSamplesPerSegment;
+    int iSegment = jmin(static_cast<int>(fParam), m_aPoints.size()-2);
+    return evaluateSegment(iSegment, fParam - iSegment);
+}
+
+String TrajectorySpline::toString() const {
+    String sPoints;
+    for (int i = 0; i < m_aPoints.size(); ++i){
+        sPoints << m_aPoints.getReference(i).x << " " << m_aPoints.getReference(i).y << " ";
+    }
+    return sPoints.trimEnd();
+}
+
+void TrajectorySpline::fromString(const String &p_sPoints){
+    clear();
+    StringArray aTokens;
+    aTokens.addTokens(p_sPoints, " ", String());
+    for (int i = 0; i+1 < aTokens.size(); i += 2){
+        m_aPoints.add(Point<float>(aTokens[i].getFloatValue(), aTokens[i+1].getFloatValue()));
+    }
+    build();
+}
+
 // ==============================================================================
 Trajectory::Trajectory(ZirkOscAudioProcessor *filter, float duration, bool syncWTempo, float times, int source)
 //:m_iSkip(0)
@@ -45,6 +123,9 @@ Trajectory::Trajectory(ZirkOscAudioProcessor *filter, float duration, bool syncW
 ,m_dTrajectoryCount(times)
 ,m_bIsSyncWTempo(syncWTempo)
 {
+    m_iWriteStartSample = 0;
+    m_dWriteStartPpq    = 0;
+
     if (mDurationSingleTrajectory < 0.0001) mDurationSingleTrajectory = 0.0001;
     if (m_dTrajectoryCount < 0.0001) m_dTrajectoryCount = 0.0001;
     
@@ -55,25 +136,27 @@ Trajectory::Trajectory(ZirkOscAudioProcessor *filter, float duration, bool syncW
     
     //store initial parameter value
     m_fStartPair.first = ourProcessor->getParameter(ZirkOscAudioProcessor::ZirkOSC_X_ParamId + m_iSelectedSourceForTrajectory*5);
-    m_fStartPair.first = m_fStartPair.first*2*ZirkOscAudioProcessor::s_iDomeRadius - ZirkOscAudioProcessor::s_iDomeRadius;
+    m_fStartPair.first = m_fStartPair.first*2 - 1;
     m_fStartPair.second = ourProcessor->getParameter(ZirkOscAudioProcessor::ZirkOSC_Y_ParamId + m_iSelectedSourceForTrajectory*5);
-    m_fStartPair.second = m_fStartPair.second*2*ZirkOscAudioProcessor::s_iDomeRadius - ZirkOscAudioProcessor::s_iDomeRadius;
+    m_fStartPair.second = m_fStartPair.second*2 - 1;
     
     m_fTrajectoryInitialAzimuth01   = SoundSource::XYtoAzim01(m_fStartPair.first, m_fStartPair.second);
     m_fTrajectoryInitialElevation01 = SoundSource::XYtoElev01(m_fStartPair.first, m_fStartPair.second);
     ourProcessor->storeCurrentLocations();
 }
 
-void Trajectory::start() {
+void Trajectory::start(const AudioPlayHead::CurrentPositionInfo &cpi) {
 	spInit();
 	mStarted = true;
     
-    AudioPlayHead::CurrentPositionInfo cpi;
-    ourProcessor->getPlayHead()->getCurrentPosition(cpi);
-    
     m_dTrajectoryTimeDone  = .0;
     m_dTrajectoryBeginTime = .0;
     
+    //remember where the host was when we started writing. Elapsed time is always recomputed from this anchor,
+    //so block size, jitter and transport jumps never accumulate as drift
+    m_iWriteStartSample = cpi.timeInSamples;
+    m_dWriteStartPpq    = cpi.ppqPosition;
+    
     if (m_bIsSyncWTempo) {
         //convert measure count to a duration
         double dMesureLength = cpi.timeSigNumerator * (4 / cpi.timeSigDenominator) *  60 / cpi.bpm;
@@ -90,23 +173,30 @@ void Trajectory::start() {
     ourProcessor->beginParameterChangeGesture(ZirkOscAudioProcessor::ZirkOSC_Y_ParamId + m_iSelectedSourceForTrajectory*5);
 }
 
-bool Trajectory::process(float seconds, float beats){
+double Trajectory::getElapsed(const AudioPlayHead::CurrentPositionInfo &cpi, double p_dSampleRate){
+    double dElapsed;
+    if (m_bIsSyncWTempo){
+        //ppq already integrates tempo changes, so this stays locked to the host grid
+        dElapsed = cpi.ppqPosition - m_dWriteStartPpq;
+    } else {
+        dElapsed = (p_dSampleRate > 0) ? (cpi.timeInSamples - m_iWriteStartSample) / p_dSampleRate : .0;
+    }
+    //pre-roll or a loop back to before the write start parks the trajectory at its beginning
+    return jmax(0., dElapsed);
+}
+
+bool Trajectory::process(const AudioPlayHead::CurrentPositionInfo &cpi, double p_dSampleRate){
     if (mStopped) {
         return true;
     } else if (!mStarted){
-        start();
+        start(cpi);
     }
-    if (mDone == m_TotalTrajectoriesDuration) {
-		spProcess(0, 0);
+    mDone = jmin(getElapsed(cpi, p_dSampleRate), m_TotalTrajectoriesDuration);
+    evaluate(mDone);
+    if (mDone >= m_TotalTrajectoriesDuration) {
 		stop();
 		return true;
 	}
-	float duration = m_bIsSyncWTempo ? beats : seconds;
-    spProcess(duration, seconds);
-	mDone += duration;
-    if (mDone > m_TotalTrajectoriesDuration){
-		mDone = m_TotalTrajectoriesDuration;
-    }
 	return false;
 }
 
@@ -157,9 +247,9 @@ public:
     ,m_fTurns(fTurns)
     {}
 protected:
-	void spProcess(float duration, float seconds){
+	void evaluate(double p_dElapsed){
         float newAzimuth, integralPart;
-        newAzimuth = mDone / mDurationSingleTrajectory;
+        newAzimuth = p_dElapsed / mDurationSingleTrajectory;
         newAzimuth = modf(newAzimuth, &integralPart);
         if (!mCCW) newAzimuth = - newAzimuth;
         newAzimuth = modf(m_fTrajectoryInitialAzimuth01 + m_fTurns * newAzimuth, &integralPart);
@@ -239,7 +329,7 @@ private:
 class SpiralTrajectory : public Trajectory
 {
 public:
-    SpiralTrajectory(ZirkOscAudioProcessor *filter, float duration, bool beats, float times, int source, bool ccw, bool rt, const std::pair<int, int> &endPoint, float fTurns)
+    SpiralTrajectory(ZirkOscAudioProcessor *filter, float duration, bool beats, float times, int source, bool ccw, bool rt, const std::pair<float, float> &endPoint, float fTurns)
     : Trajectory(filter, duration, beats, times, source)
     , mCCW(ccw)
     , m_bRT(rt)
@@ -251,9 +341,9 @@ protected:
     void spInit(){
 
     }
-    void spProcess(float duration, float seconds){
+    void evaluate(double p_dElapsed){
         float newAzimuth01, theta, integralPart; //integralPart is only a temp buffer
-        float newElevation01 = mDone / mDurationSingleTrajectory;
+        float newElevation01 = p_dElapsed / mDurationSingleTrajectory;
         theta = modf(newElevation01, &integralPart);                                          //result from this modf is theta [0,1]
         float fTranslationFactor = theta;
         
@@ -264,10 +354,10 @@ protected:
         //UP AND DOWN SPIRAL
         if (m_bRT){
             if (mIn){
-                newElevation01 = abs( (1 - fCurStartElev01) * sin(newElevation01 * M_PI) ) + fCurStartElev01;
+                newElevation01 = abs( (1 - fCurStartElev01) * ZirkMath::sin(newElevation01 * ZirkMath::kPi) ) + fCurStartElev01;
             } else {
                 JUCE_COMPILER_WARNING("mIn is always true; so either delete this or create another trajectory/mode for it")
-                newElevation01 = abs( fCurStartElev01 * cos(newElevation01 * M_PI) );  //only positive cos wave with phase _TrajectoriesPhi
+                newElevation01 = abs( fCurStartElev01 * ZirkMath::cos(newElevation01 * ZirkMath::kPi) );  //only positive cos wave with phase _TrajectoriesPhi
             }
             if (theta > .5){
                 fTranslationFactor = 1 - theta;
@@ -329,19 +419,19 @@ protected:
             m_fB = m_fStartPair.first;
         }
     }
-    void spProcess(float duration, float seconds) {
+    void evaluate(double p_dElapsed) {
 
         int iReturn = m_bRT ? 2:1;
-        float fCurDampening = m_fTotalDampening * mDone / (mDurationSingleTrajectory * m_dTrajectoryCount);
+        float fCurDampening = m_fTotalDampening * p_dElapsed / (mDurationSingleTrajectory * m_dTrajectoryCount);
         //pendulum part
-        float newX, newY, temp, fCurrentProgress = modf((mDone / mDurationSingleTrajectory), &temp);
+        float newX, newY, temp, fCurrentProgress = modf((p_dElapsed / mDurationSingleTrajectory), &temp);
 
         if (m_bYisDependent){
-            fCurrentProgress = (m_fEndPair.first - m_fStartPair.first) * (1-cos(fCurrentProgress * iReturn * M_PI)) / 2;
+            fCurrentProgress = (m_fEndPair.first - m_fStartPair.first) * (1-ZirkMath::cos(fCurrentProgress * iReturn * ZirkMath::kPi)) / 2;
             newX = m_fStartPair.first + fCurrentProgress;
             newY = m_fM * newX + m_fB;
         } else {
-            fCurrentProgress = (m_fEndPair.second - m_fStartPair.second) * (1-cos(fCurrentProgress * iReturn * M_PI)) / 2;
+            fCurrentProgress = (m_fEndPair.second - m_fStartPair.second) * (1-ZirkMath::cos(fCurrentProgress * iReturn * ZirkMath::kPi)) / 2;
             newX = m_fStartPair.first;
             newY = m_fStartPair.second + fCurrentProgress;
         }
@@ -352,7 +442,7 @@ protected:
         
         //circle part
         float newAzimuth, integralPart;
-        newAzimuth = mDone / (mDurationSingleTrajectory * m_dTrajectoryCount);
+        newAzimuth = p_dElapsed / (mDurationSingleTrajectory * m_dTrajectoryCount);
         newAzimuth = modf(newAzimuth, &integralPart);
         if (!mCCW) {
             newAzimuth = - newAzimuth;
@@ -385,11 +475,11 @@ protected:
 //		for (int i = 0; i < mFilter->getNumberOfSources(); i++)
 //			mSourcesInitRT.add(mFilter->getSourceRT(i));
 	}
-    void spProcess(float duration, float seconds)
+    void evaluate(double p_dElapsed)
     {
         
         float integralPart; //useless here
-        float theta = mDone / mDurationSingleTrajectory;   //goes from 0 to m_dTrajectoryCount
+        float theta = p_dElapsed / mDurationSingleTrajectory;   //goes from 0 to m_dTrajectoryCount
         theta = modf(theta, &integralPart); //does 0 -> 1 for m_dTrajectoryCount times
         if (!mCCW) theta = -theta;
         
@@ -397,7 +487,7 @@ protected:
         
         float newAzimuth = m_fTrajectoryInitialAzimuth01 + theta;
         
-        float newElevation = m_fTrajectoryInitialElevation01 + (1-m_fTrajectoryInitialElevation01)/2 * abs(sin(theta * 2 * M_PI));
+        float newElevation = m_fTrajectoryInitialElevation01 + (1-m_fTrajectoryInitialElevation01)/2 * abs(ZirkMath::sin(theta * ZirkMath::kTwoPi));
         
         move(newAzimuth, newElevation);
     }
@@ -409,120 +499,81 @@ private:
 };
 
 // ==============================================================================
-// Mersenne Twister random number generator, this is now included in c++11, see here: http://en.cppreference.com/w/cpp/numeric/random
-class MTRand_int32
+class RandomTrajectory : public Trajectory
 {
 public:
-	MTRand_int32()
-	{
-		seed(rand());
-	}
-	uint32_t rand_uint32()
-	{
-		if (p == n) gen_state();
-		unsigned long x = state[p++];
-		x ^= (x >> 11);
-		x ^= (x << 7) & 0x9D2C5680;
-		x ^= (x << 15) & 0xEFC60000;
-		return x ^ (x >> 18);
-	}
-	void seed(uint32_t s)
-	{
-		state[0] = s;
-		for (int i = 1; i < n; ++i)
-			state[i] = 1812433253 * (state[i - 1] ^ (state[i - 1] >> 30)) + i;
-
-		p = n; // force gen_state() to be called for next random number
-	}
-
+	RandomTrajectory(ZirkOscAudioProcessor *filter, float duration, bool beats, float times, int source, float fSpeed, float fRoughness, int iSeed)
+	: Trajectory(filter, duration, beats, times, source)
+    , m_fSpeed(fSpeed)
+    , m_fRoughness(fRoughness)
+    , m_iSeedX(ZirkRandom::mix(static_cast<uint32_t>(iSeed)))
+    , m_iSeedY(ZirkRandom::mix(static_cast<uint32_t>(iSeed) + 1))
+    , m_fNoiseAtStartX(ZirkNoise::fractalNoise(m_iSeedX, 0, fRoughness))
+    , m_fNoiseAtStartY(ZirkNoise::fractalNoise(m_iSeedY, 0, fRoughness))
+    {}
+	
+protected:
+    //position is start location + noise(t) - noise(0), so any block can be computed directly, the path starts at the source
+    //and nothing is read back from the parameters
+    void evaluate(double p_dElapsed)
+    {
+        double dPhase = p_dElapsed * m_fSpeed;
+        
+        float fX = m_fStartPair.first  + ZirkNoise::fractalNoise(m_iSeedX, dPhase, m_fRoughness) - m_fNoiseAtStartX;
+        float fY = m_fStartPair.second + ZirkNoise::fractalNoise(m_iSeedY, dPhase, m_fRoughness) - m_fNoiseAtStartY;
+        
+        //keep the source inside the dome
+        float fDistance = hypotf(fX, fY);
+        if (fDistance > 1){
+            fX /= fDistance;
+            fY /= fDistance;
+        }
+        moveXY(fX, fY);
+    }
 private:
-	static const int n = 624, m = 397;
-	int p;
-	unsigned long state[n];
-	unsigned long twiddle(uint32_t u, uint32_t v)
-	{
-		return (((u & 0x80000000) | (v & 0x7FFFFFFF)) >> 1) ^ ((v & 1) * 0x9908B0DF);
-	}
-	void gen_state()
-	{
-		for (int i = 0; i < (n - m); ++i)
-			state[i] = state[i + m] ^ twiddle(state[i], state[i + 1]);
-		for (int i = n - m; i < (n - 1); ++i)
-			state[i] = state[i + m - n] ^ twiddle(state[i], state[i + 1]);
-		state[n - 1] = state[m - 1] ^ twiddle(state[n - 1], state[0]);
-		
-		p = 0; // reset position
-	}
-	// make copy constructor and assignment operator unavailable, they don't make sense
-	MTRand_int32(const MTRand_int32&);
-	void operator=(const MTRand_int32&);
+	float m_fSpeed;
+    float m_fRoughness;
+    uint32_t m_iSeedX, m_iSeedY;
+    float m_fNoiseAtStartX, m_fNoiseAtStartY;
 };
 
-
-class RandomTrajectory : public Trajectory
+// ==============================================================================
+class DrawnTrajectory : public Trajectory
 {
 public:
-	RandomTrajectory(ZirkOscAudioProcessor *filter, float duration, bool beats, float times, int source, float speed)
-	: Trajectory(filter, duration, beats, times, source), mClock(0), mSpeed(speed) {}
-	
+    DrawnTrajectory(ZirkOscAudioProcessor *filter, float duration, bool beats, float times, int source, bool bEased, bool rt, const TrajectorySpline &p_oSpline)
+    : Trajectory(filter, duration, beats, times, source)
+    , m_bEased(bEased)
+    , m_bRT(rt)
+    , m_oSpline(p_oSpline)
+    {}
+    
 protected:
-//	void spProcess(float duration, float seconds)
-//	{
-//        mClock += seconds;
-//        while(mClock > 0.01) {
-//            float fAzimuth, fElevation;
-//            mClock -= 0.01;
-//            if (ZirkOscAudioProcessor::s_bUseXY){
-//
-//                float fX = ourProcessor->getParameter(ZirkOscAudioProcessor::ZirkOSC_X_ParamId + m_iSelectedSourceForTrajectory*5);
-//                float fY = ourProcessor->getParameter(ZirkOscAudioProcessor::ZirkOSC_Y_ParamId + m_iSelectedSourceForTrajectory*5);
-//                
-//                SoundSource::XY01toAzimElev01(fX, fY, fAzimuth, fElevation);
-//                
-//            } else {
-//                fAzimuth  = ourProcessor->getParameter(ZirkOscAudioProcessor::ZirkOSC_X_ParamId + m_iSelectedSourceForTrajectory*5);
-//                fElevation= ourProcessor->getParameter(ZirkOscAudioProcessor::ZirkOSC_Y_ParamId + m_iSelectedSourceForTrajectory*5);
-//            }
-//            float r1 = mRNG.rand_uint32() / (float)0xFFFFFFFF;
-//            float r2 = mRNG.rand_uint32() / (float)0xFFFFFFFF;
-//            fAzimuth += (r1 - 0.5) * mSpeed;
-//            fElevation += (r2 - 0.5) * mSpeed;
-//            move(fAzimuth, fElevation);
-//        }
-//	}
-
-    void spProcess(float duration, float seconds)
+    void evaluate(double p_dElapsed)
     {
-        mClock += seconds;
-        while(mClock > 0.01) {
-
-            mClock -= 0.01;
-
-            float fX01 = ourProcessor->getParameter(ZirkOscAudioProcessor::ZirkOSC_X_ParamId + m_iSelectedSourceForTrajectory*5);
-            float fY01 = ourProcessor->getParameter(ZirkOscAudioProcessor::ZirkOSC_Y_ParamId + m_iSelectedSourceForTrajectory*5);
-            
-            float r1 = mRNG.rand_uint32() / (float)0xFFFFFFFF;
-            float r2 = mRNG.rand_uint32() / (float)0xFFFFFFFF;
-            
-            fX01 += (r1 - 0.5) * mSpeed;
-            fY01 += (r2 - 0.5) * mSpeed;
-            
-            float fX = PercentToHR(fX01, -ZirkOscAudioProcessor::s_iDomeRadius, ZirkOscAudioProcessor::s_iDomeRadius);
-            float fY = PercentToHR(fY01, -ZirkOscAudioProcessor::s_iDomeRadius, ZirkOscAudioProcessor::s_iDomeRadius);
-            
-//            JUCE_COMPILER_WARNING("there has to be a way to have the random values be in the correct range without clamping...")
-//            fX = clamp(fX, static_cast<float>(-ZirkOscAudioProcessor::s_iDomeRadius), static_cast<float>(ZirkOscAudioProcessor::s_iDomeRadius));
-//            fY = clamp(fY, static_cast<float>(-ZirkOscAudioProcessor::s_iDomeRadius), static_cast<float>(ZirkOscAudioProcessor::s_iDomeRadius));
-            
-            moveXY(fX, fY);
-
-
+        if (m_oSpline.isEmpty()){
+            return;
         }
+        double dCycles = p_dElapsed / mDurationSingleTrajectory;
+        float fProgress = dCycles - floor(dCycles);
+        //the end of a cycle is the end of the path, not the beginning of the next one
+        if (fProgress == 0 && dCycles > 0){
+            fProgress = 1;
+        }
+        if (m_bRT){
+            fProgress = (fProgress < .5f) ? 2 * fProgress : 2 - 2 * fProgress;
+        }
+        if (m_bEased){
+            fProgress = fProgress * fProgress * (3 - 2 * fProgress);
+        }
+        Point<float> oPoint = m_oSpline.getPointAtDistance01(fProgress);
+        moveXY(oPoint.x, oPoint.y);
     }
+    
 private:
-	MTRand_int32 mRNG;
-	float mClock;
-	float mSpeed;
+    bool m_bEased, m_bRT;
+    //! our own copy, so that drawing a new gesture while writing does not affect the audio thread
+    TrajectorySpline m_oSpline;
 };
 
 // ==============================================================================
@@ -535,7 +586,7 @@ public:
 protected:
 //	virtual FPoint destinationForSource(int s, FPoint o) = 0;
 
-	void spProcess(float duration, float seconds)
+	void evaluate(double)
 	{
 //		float p = mDone / mDurationSingleTrajectory;
 //		
@@ -596,9 +647,6 @@ protected:
 //		}
 //		return FPoint(x,y);
 //	}
-	
-private:
-	MTRand_int32 mRNG;
 };
 
 // ==============================================================================
@@ -666,6 +714,7 @@ String Trajectory::GetTrajectoryName(int i){
         case Spiral: return "Spiral";
         case Pendulum: return "Pendulum";
         case AllTrajectoryTypes::Random: return "Random";
+        case Drawn: return "Drawn";
 	}
 	jassert(0);
 	return "";
@@ -682,9 +731,10 @@ std::unique_ptr<vector<String>> Trajectory::getTrajectoryPossibleDirections(int
             vDirections->push_back("Counter Clockwise");
             break;
         case AllTrajectoryTypes::Random:
-            vDirections->push_back("Slow");
-            vDirections->push_back("Mid");
-            vDirections->push_back("Fast");
+            return nullptr;
+        case Drawn:
+            vDirections->push_back("Constant speed");
+            vDirections->push_back("Eased");
             break;
         default:
             jassert(0);
@@ -701,7 +751,11 @@ unique_ptr<AllTrajectoryDirections> Trajectory::getTrajectoryDirection(int p_iSe
             *pDirection = static_cast<AllTrajectoryDirections>(p_iSelectedDirection);
             break;
         case AllTrajectoryTypes::Random:
-            *pDirection = static_cast<AllTrajectoryDirections>(p_iSelectedDirection+9);
+            //random motion has no direction
+            *pDirection = CW;
+            break;
+        case Drawn:
+            *pDirection = static_cast<AllTrajectoryDirections>(p_iSelectedDirection+ConstantSpeed);
             break;
         default:
             break;
@@ -717,6 +771,7 @@ std::unique_ptr<vector<String>> Trajectory::getTrajectoryPossibleReturns(int p_i
             return nullptr;
         case Spiral:
         case Pendulum:
+        case Drawn:
             vReturns->push_back("One Way");
             vReturns->push_back("Return");
             break;
@@ -726,9 +781,9 @@ std::unique_ptr<vector<String>> Trajectory::getTrajectoryPossibleReturns(int p_i
     return vReturns;
 }
 Trajectory::Ptr Trajectory::CreateTrajectory(int type, ZirkOscAudioProcessor *filter, float duration, bool beats, AllTrajectoryDirections direction,
-                                             bool bReturn, float times, int source, const std::pair<float, float> &endPair, float fTurns, float fDeviation, float fDampening){
-    bool ccw, in, cross;
-    float speed;
+                                             bool bReturn, float times, int source, const std::pair<float, float> &endPair, float fTurns, float fDeviation, float fDampening,
+                                             float fRandomSpeed, float fRandomRoughness, int iSeed, const TrajectorySpline &p_oDrawnSpline){
+    bool ccw, in, cross, eased = false;
     switch (direction) {
         case CW:
             ccw = false;
@@ -764,14 +819,11 @@ Trajectory::Ptr Trajectory::CreateTrajectory(int type, ZirkOscAudioProcessor *fi
             in = false;
             ccw = true;
             break;
-        case Slow:
-            speed = .02;
-            break;
-        case Mid:
-            speed = .04;
+        case ConstantSpeed:
+            eased = false;
             break;
-        case Fast:
-            speed = .06;
+        case Eased:
+            eased = true;
             break;
         default:
             break;
@@ -782,7 +834,8 @@ Trajectory::Ptr Trajectory::CreateTrajectory(int type, ZirkOscAudioProcessor *fi
         case Ellipse:                    return new EllipseTrajectory   (filter, duration, beats, times, source, ccw, fTurns);
         case Spiral:                     return new SpiralTrajectory    (filter, duration, beats, times, source, ccw, bReturn, endPair, fTurns);
         case Pendulum:                   return new PendulumTrajectory  (filter, duration, beats, times, source, ccw, bReturn, endPair, fDeviation, fDampening);
-        case AllTrajectoryTypes::Random: return new RandomTrajectory    (filter, duration, beats, times, source, speed);
+        case AllTrajectoryTypes::Random: return new RandomTrajectory    (filter, duration, beats, times, source, fRandomSpeed, fRandomRoughness, iSeed);
+        case Drawn:                      return new DrawnTrajectory     (filter, duration, beats, times, source, eased, bReturn, p_oDrawnSpline);
             
             //      case 19: return new RandomTargetTrajectory(filter, duration, beats, times, source);
             //		case 20: return new SymXTargetTrajectory(filter, duration, beats, times, source);
@@ -791,4 +844,4 @@ Trajectory::Ptr Trajectory::CreateTrajectory(int type, ZirkOscAudioProcessor *fi
     }
     jassert(0);
     return NULL;
-}
\ No newline at end of file
+}
\ No newline at end of file
@@ -32,6 +32,46 @@
 
 class ZirkOscAudioProcessor;
 
+//! Catmull-Rom spline through a gesture drawn on the dome. Points are in the same [-1,1] dome coordinates as the sources,
+//! so the spline does not depend on the window size. After build(), a cumulative arc-length table lets us find the point at
+//! any fraction of the total length with a binary search.
+class TrajectorySpline
+{
+public:
+    void clear();
+    //! add a drawn point, skipping points that are too close to the previous one to keep the spline compact
+    void addPoint(float p_fX, float p_fY);
+    int getNumPoints() const {
+        return m_aPoints.size();
+    }
+    Point<float> getPoint(int p_iPoint) const {
+        return m_aPoints.getReference(p_iPoint);
+    }
+    //! we need at least 2 points to have a path
+    bool isEmpty() const {
+        return m_aPoints.size() < 2;
+    }
+    //! compute the arc-length table, call this once all points are added
+    void build();
+    float getLength() const {
+        return m_aCumulativeLength.size() == 0 ? 0 : m_aCumulativeLength.getLast();
+    }
+    //! point located at p_fDistance01 of the total length, in O(log n)
+    Point<float> getPointAtDistance01(float p_fDistance01) const;
+    
+    //! points as "x y x y ...", used to store the spline in the plugin state
+    String toString() const;
+    void fromString(const String &p_sPoints);
+    
+private:
+    Point<float> evaluateSegment(int p_iSegment, float t) const;
+    
+    Array<Point<float>> m_aPoints;
+    //! m_aCumulativeLength[k] is the length of the spline from its start to parameter k / s_kiSamplesPerSegment
+    Array<float> m_aCumulativeLength;
+    static const int s_kiSamplesPerSegment = 8;
+};
+
 class Trajectory : public ReferenceCountedObject
 {
 public:
@@ -39,14 +79,16 @@ public:
 	static int NumberOfTrajectories();
 	static String GetTrajectoryName(int i);
     static Trajectory::Ptr CreateTrajectory(int i, ZirkOscAudioProcessor *filter, float duration, bool beats, AllTrajectoryDirections direction, bool bReturn,
-                                            float times, int source, const std::pair<float, float> &endPoint, float fTurns, float fDeviation, float fDampening);
+                                            float times, int source, const std::pair<float, float> &endPoint, float fTurns, float fDeviation, float fDampening,
+                                            float fRandomSpeed, float fRandomRoughness, int iSeed, const TrajectorySpline &p_oDrawnSpline);
 	
 public:
 	virtual ~Trajectory() {
         stop();
     }
 	
-	bool process(float seconds, float beats);
+	//! Evaluate the trajectory at the current host position. Returns true when the trajectory is done
+	bool process(const AudioPlayHead::CurrentPositionInfo &cpi, double p_dSampleRate);
 	float progress();
     float progressCycle();
 	void stop();
@@ -58,13 +100,19 @@ public:
 
 protected:
 	virtual void spInit() {}
-	virtual void spProcess(float duration, float seconds) = 0;
+    //! Move the source to where the trajectory is at p_dElapsed, which is in beats when synced with tempo and in seconds otherwise
+	virtual void evaluate(double p_dElapsed) = 0;
     void move (float newAzimuth, float newElevation);
     void moveXY (const float &p_fNewX, const float &p_fNewY);
 	
 private:
-	void start();
+	void start(const AudioPlayHead::CurrentPositionInfo &cpi);
+    double getElapsed(const AudioPlayHead::CurrentPositionInfo &cpi, double p_dSampleRate);
 //    int m_iSkip;
+    
+    //! Host position when writing started; trajectory time is always derived from these, so that loops and relocations land on the right phase
+    int64  m_iWriteStartSample;
+    double m_dWriteStartPpq;
 	
 protected:
 	Trajectory(ZirkOscAudioProcessor *filter, float duration, bool beats, float times, int source);
@@ -73,7 +121,7 @@ protected:
 
 	bool mStarted, mStopped;
 
-	float mDone;
+	double mDone;
     
     float mDurationSingleTrajectory;
     
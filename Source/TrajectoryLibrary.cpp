@@ -0,0 +1,219 @@
+/*
+ ==============================================================================
+ ZirkOSC: VST and AU audio plug-in enabling spatial movement of sound sources in a dome of speakers.
+
+ Copyright (C) 2015  GRIS-UdeM
+
+ Developers: Ludovic Laffineur, Vincent Berthiaume
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ==============================================================================
+ */
+
+#include "TrajectoryLibrary.h"
+
+namespace {
+    const char kMagic[4] = {'Z', 'K', 'T', 'L'};
+
+    enum EntryFlags {
+        kSyncWTempo = 1
+    };
+
+    //! bounds-checked little-endian reads straight from the mapped file
+    class LibraryReader {
+    public:
+        LibraryReader(const void *p_pData, size_t p_iSize)
+        :m_pCur(static_cast<const char*>(p_pData))
+        ,m_pEnd(static_cast<const char*>(p_pData) + p_iSize)
+        ,m_bValid(true)
+        {}
+
+        bool isValid() const {
+            return m_bValid;
+        }
+        bool canRead(size_t p_iBytes){
+            if (m_bValid && static_cast<size_t>(m_pEnd - m_pCur) >= p_iBytes){
+                return true;
+            }
+            m_bValid = false;
+            return false;
+        }
+        const char* readBytes(size_t p_iBytes){
+            if (!canRead(p_iBytes)){
+                return nullptr;
+            }
+            const char *pBytes = m_pCur;
+            m_pCur += p_iBytes;
+            return pBytes;
+        }
+        uint32 readUInt32(){
+            const char *pBytes = readBytes(4);
+            return pBytes ? ByteOrder::littleEndianInt(pBytes) : 0;
+        }
+        int readInt32(){
+            return static_cast<int>(readUInt32());
+        }
+        float readFloat(){
+            union { uint32 i; float f; } value;
+            value.i = readUInt32();
+            return value.f;
+        }
+    private:
+        const char *m_pCur;
+        const char *m_pEnd;
+        bool m_bValid;
+    };
+}
+
+File TrajectoryLibrary::getDefaultFile(){
+    return File::getSpecialLocation(File::userApplicationDataDirectory).getChildFile("GRIS").getChildFile("ZirkOSC").getChildFile("Trajectories.ztl");
+}
+
+TrajectoryLibrary::LoadResult TrajectoryLibrary::load(const File &p_oFile){
+    m_aEntries.clear();
+
+    if (!p_oFile.existsAsFile() || p_oFile.getSize() == 0){
+        return kLibraryMissing;
+    }
+    MemoryMappedFile oMappedFile(p_oFile, MemoryMappedFile::readOnly);
+    if (oMappedFile.getData() == nullptr){
+        return kLibraryUnreadable;
+    }
+    LibraryReader oReader(oMappedFile.getData(), oMappedFile.getSize());
+
+    const char *pMagic = oReader.readBytes(4);
+    if (pMagic == nullptr || memcmp(pMagic, kMagic, 4) != 0){
+        return kLibraryUnreadable;
+    }
+    const uint32 iVersion = oReader.readUInt32();
+    if (iVersion > s_kiVersion){
+        return kLibraryUnreadable;
+    }
+    uint32 iCount = oReader.readUInt32();
+    m_aEntries.ensureStorageAllocated(static_cast<int>(jmin(iCount, 10000u)));
+
+    for (uint32 iEntry = 0; iEntry < iCount && oReader.isValid(); ++iEntry){
+        ScopedPointer<TrajectoryLibraryEntry> pEntry(new TrajectoryLibraryEntry());
+
+        uint32 iNameSize = oReader.readUInt32();
+        const char *pName = oReader.readBytes(iNameSize);
+        if (pName == nullptr){
+            break;
+        }
+        pEntry->m_sName         = String::fromUTF8(pName, static_cast<int>(iNameSize));
+        pEntry->m_iType         = oReader.readInt32();
+        int iFlags              = oReader.readInt32();
+        pEntry->m_bSyncWTempo   = (iFlags & kSyncWTempo) != 0;
+        pEntry->m_fDirection01  = oReader.readFloat();
+        pEntry->m_fReturn01     = oReader.readFloat();
+        pEntry->m_fDuration     = oReader.readFloat();
+        pEntry->m_fCount        = oReader.readFloat();
+        pEntry->m_fTurns        = oReader.readFloat();
+        pEntry->m_fDeviation    = oReader.readFloat();
+        pEntry->m_fDampening    = oReader.readFloat();
+        pEntry->m_fRandomSpeed  = oReader.readFloat();
+        pEntry->m_fRoughness    = oReader.readFloat();
+        pEntry->m_iSeed         = oReader.readInt32();
+        if (iVersion >= 2){
+            pEntry->m_fEndX     = oReader.readFloat();
+            pEntry->m_fEndY     = oReader.readFloat();
+        }
+
+        uint32 iPoints = oReader.readUInt32();
+        if (!oReader.canRead(static_cast<size_t>(iPoints) * 8)){
+            break;
+        }
+        for (uint32 iPoint = 0; iPoint < iPoints; ++iPoint){
+            float fX = oReader.readFloat();
+            float fY = oReader.readFloat();
+            pEntry->m_oSpline.addPoint(fX, fY);
+        }
+        pEntry->m_oSpline.build();
+
+        if (oReader.isValid()){
+            m_aEntries.add(pEntry.release());
+        }
+    }
+    return oReader.isValid() ? kLibraryLoaded : kLibraryUnreadable;
+}
+
+bool TrajectoryLibrary::save(const File &p_oFile) const {
+    if (!p_oFile.getParentDirectory().createDirectory()){
+        return false;
+    }
+    //write next to the library and swap, so other instances never map a half-written file
+    TemporaryFile oTemp(p_oFile);
+    {
+        FileOutputStream oStream(oTemp.getFile());
+        if (oStream.failedToOpen()){
+            return false;
+        }
+        oStream.write(kMagic, 4);
+        oStream.writeInt(static_cast<int>(s_kiVersion));
+        oStream.writeInt(m_aEntries.size());
+
+        for (int iEntry = 0; iEntry < m_aEntries.size(); ++iEntry){
+            const TrajectoryLibraryEntry &oEntry = *m_aEntries[iEntry];
+            const int iNameSize = static_cast<int>(oEntry.m_sName.getNumBytesAsUTF8());
+            oStream.writeInt(iNameSize);
+            oStream.write(oEntry.m_sName.toRawUTF8(), iNameSize);
+            oStream.writeInt(oEntry.m_iType);
+            oStream.writeInt(oEntry.m_bSyncWTempo ? kSyncWTempo : 0);
+            oStream.writeFloat(oEntry.m_fDirection01);
+            oStream.writeFloat(oEntry.m_fReturn01);
+            oStream.writeFloat(oEntry.m_fDuration);
+            oStream.writeFloat(oEntry.m_fCount);
+            oStream.writeFloat(oEntry.m_fTurns);
+            oStream.writeFloat(oEntry.m_fDeviation);
+            oStream.writeFloat(oEntry.m_fDampening);
+            oStream.writeFloat(oEntry.m_fRandomSpeed);
+            oStream.writeFloat(oEntry.m_fRoughness);
+            oStream.writeInt(oEntry.m_iSeed);
+            oStream.writeFloat(oEntry.m_fEndX);
+            oStream.writeFloat(oEntry.m_fEndY);
+            oStream.writeInt(oEntry.m_oSpline.getNumPoints());
+            for (int iPoint = 0; iPoint < oEntry.m_oSpline.getNumPoints(); ++iPoint){
+                oStream.writeFloat(oEntry.m_oSpline.getPoint(iPoint).x);
+                oStream.writeFloat(oEntry.m_oSpline.getPoint(iPoint).y);
+            }
+        }
+        oStream.flush();
+        if (oStream.getStatus().failed()){
+            return false;
+        }
+    }
+    return oTemp.overwriteTargetFileWithTemporary();
+}
+
+int TrajectoryLibrary::indexOf(const String &p_sName) const {
+    for (int iEntry = 0; iEntry < m_aEntries.size(); ++iEntry){
+        if (m_aEntries[iEntry]->m_sName == p_sName){
+            return iEntry;
+        }
+    }
+    return -1;
+}
+
+void TrajectoryLibrary::set(const TrajectoryLibraryEntry &p_oEntry){
+    int iEntry = indexOf(p_oEntry.m_sName);
+    if (iEntry == -1){
+        m_aEntries.add(new TrajectoryLibraryEntry(p_oEntry));
+    } else {
+        *m_aEntries[iEntry] = p_oEntry;
+    }
+}
+
+void TrajectoryLibrary::remove(int p_iEntry){
+    m_aEntries.remove(p_iEntry);
+}
@@ -0,0 +1,92 @@
+/*
+ ==============================================================================
+ ZirkOSC: VST and AU audio plug-in enabling spatial movement of sound sources in a dome of speakers.
+
+ Copyright (C) 2015  GRIS-UdeM
+
+ Developers: Ludovic Laffineur, Vincent Berthiaume
+
+ This program is free software: you can redistribute it and/or modify
+ it under the terms of the GNU General Public License as published by
+ the Free Software Foundation, either version 3 of the License, or
+ (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ==============================================================================
+ */
+
+#ifndef __ZirkOSCJUCE__TrajectoryLibrary__
+#define __ZirkOSCJUCE__TrajectoryLibrary__
+
+#include "../JuceLibraryCode/JuceHeader.h"
+#include "Trajectories.h"
+
+//! One named trajectory: the Trajectories tab settings plus the drawn keyframes, if any
+struct TrajectoryLibraryEntry {
+    String  m_sName;
+    int     m_iType         = Circle;
+    float   m_fDirection01  = 0;
+    float   m_fReturn01     = 0;
+    float   m_fDuration     = 5;
+    float   m_fCount        = 1;
+    bool    m_bSyncWTempo   = false;
+    float   m_fTurns        = 1;
+    float   m_fDeviation    = 0;
+    float   m_fDampening    = 0;
+    float   m_fRandomSpeed  = 1;
+    float   m_fRoughness    = .5;
+    int     m_iSeed         = 1;
+    //! Spiral and Pendulum end point, x and y in [-1, 1]
+    float   m_fEndX         = 0;
+    float   m_fEndY         = 0;
+    TrajectorySpline m_oSpline;
+};
+
+//! Trajectories saved to a binary file, so that they can be shared between instances and sessions.
+//! All values are little-endian:
+//!     "ZKTL", uint32 version, uint32 entry count, then for each entry:
+//!     uint32 name size, utf-8 name, int32 type, int32 flags, 9 float settings, int32 seed, float end x, float end y, uint32 point count, point count * (float x, float y)
+//! Version 1 files have no end point; their entries load with the end point at the centre.
+//! The file is memory-mapped and read in place, there is no parsing step.
+class TrajectoryLibrary {
+public:
+    //! shared by all instances: <user app data>/GRIS/ZirkOSC/Trajectories.ztl
+    static File getDefaultFile();
+
+    enum LoadResult {
+        kLibraryLoaded,
+        //! no file yet: the library is empty and saving creates the file
+        kLibraryMissing,
+        //! bad magic, newer version or truncated data: the library holds the entries read before the problem, if any,
+        //! and must not be saved over the file, which would lose what we could not read
+        kLibraryUnreadable
+    };
+    //! replace the current content with the file's
+    LoadResult load(const File &p_oFile);
+    //! write to a temporary file and swap it in; returns false if the file could not be written
+    bool save(const File &p_oFile) const;
+
+    int size() const {
+        return m_aEntries.size();
+    }
+    const TrajectoryLibraryEntry& getEntry(int p_iEntry) const {
+        return *m_aEntries[p_iEntry];
+    }
+    //! index of the entry with that name, or -1
+    int indexOf(const String &p_sName) const;
+    //! add p_oEntry, replacing any entry with the same name
+    void set(const TrajectoryLibraryEntry &p_oEntry);
+    void remove(int p_iEntry);
+
+private:
+    static const uint32 s_kiVersion = 2;
+    OwnedArray<TrajectoryLibraryEntry> m_aEntries;
+};
+
+#endif /* defined(__ZirkOSCJUCE__TrajectoryLibrary__) */
@@ -71,12 +71,12 @@ const String ZirkOSC_NbrTrajectories_name = "NbrTrajectories";
 const String ZirkOSC_DurationTrajectories_name = "TrajDuration";
 const String ZirkOSCm_bIsSyncWTempo_name = "SyncWTempo";
 const String ZirkOSCm_bIsWriteTrajectory_name = "WriteTrajectory";
+const String ZirkOSC_Morph_name = "Morph";
 
 const String ZirkOSCm_iSourceId_name [ZirkOSC_Max_Sources] = {"1 Channel", "2 Channel","3 Channel","4 Channel","5 Channel","6 Channel","7 Channel","8 Channel"};
 
-const int ZirkOSC_reg_timerDelay = 50;// 50 = 1000 / 20; or 20fps
-
-const int ZirkOSC_traj_timerDelay = 100;
+//! editors are repainted at most once per frame, and only when something changed
+const int ZirkOSC_frame_timerDelay = 16;// 16 = 1000 / 60; or 60fps
 
 const int ZirkOSC_SlidersGroupHeight = 220;
 
@@ -84,6 +84,10 @@ const int ZirkOSC_ConstraintComboBoxHeight = 25;
 
 const float kiSrcRadius   = 10;
 const float kiSrcDiameter  = 2 * kiSrcRadius;
+//! size of a pre-rendered source marker: the marker, its outline and the shadow of its label
+const int kiSrcSpriteSize = kiSrcDiameter + 4;
+//! the dome view can be zoomed from 1 (whole dome) to this
+const float kfMaxDomeZoom = 8;
 const int ZirkOSC_Window_Default_Width  = 430 + kiSrcRadius;
 const int ZirkOSC_Window_Default_Height = 350 + ZirkOSC_ConstraintComboBoxHeight + ZirkOSC_SlidersGroupHeight;
 const int kiLM = 15;
@@ -116,6 +120,7 @@ enum AllTrajectoryTypes {
     Spiral,
     Pendulum,
     Random,
+    Drawn,
     TotalNumberTrajectories    
 };
 
@@ -129,15 +134,8 @@ enum AllTrajectoryDirections {
     InCCW,
     OutCW,
     OutCCW,
-    Slow,
-    Mid,
-    Fast
-};
-
-enum ElevationStatus{
-    normalRange,
-    over1,
-    under0
+    ConstantSpeed,
+    Eased
 };
 
 enum AllSyncOptions {
@@ -88,13 +88,14 @@ void ZirkLeap::onFrame(const Leap::Controller& controller) {
                         int src = ourProcessor->getSelectedSource();
                         float fX, fY;
                         ourProcessor->getSources()[src].getXY(fX, fY);
-                        fX += delta.x * scale;
-                        fY -= delta.y * scale;
+                        //the hand moves in pixels on screen, source positions are in dome coordinates
+                        fX += delta.x * scale / mEditor->getDomeRadius();
+                        fY -= delta.y * scale / mEditor->getDomeRadius();
                         
                         //clamp coordinates to circle
                         float fCurR = hypotf(fX, fY);
-                        if ( fCurR > ZirkOscAudioProcessor::s_iDomeRadius){
-                            float fExtraRatio = ZirkOscAudioProcessor::s_iDomeRadius / fCurR;
+                        if ( fCurR > 1){
+                            float fExtraRatio = 1 / fCurR;
                             fX *= fExtraRatio;
                             fY *= fExtraRatio;
                         }